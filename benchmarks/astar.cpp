@@ -0,0 +1,58 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int width = argc > 1 ? stoi(argv[1]) : 1000;
+    int height = argc > 2 ? stoi(argv[2]) : 1000;
+    int queries = argc > 3 ? stoi(argv[3]) : 20;
+
+    cout << "Grid: " << width << " x " << height << ", queries: " << queries << '\n';
+    vector<tuple<int, int, int>> edges = grid_edges(width, height);
+
+    Graph<int, int> G;
+    for (auto &e : edges)
+        G.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    CsrGraph<int, int> C = G.freeze();
+
+    // Every edge weighs at least 10, so 10 * Manhattan distance is a lower bound
+    auto manhattan = [width](int a, int b) { return 10 * (abs(a % width - b % width) + abs(a / width - b / width)); };
+
+    mt19937 gen(7);
+    uniform_int_distribution<int> node(0, width * height - 1);
+    vector<pair<int, int>> pairs;
+    for (int i = 0; i < queries; ++i)
+        pairs.emplace_back(node(gen), node(gen));
+
+    long long checksum = 0;
+    measure("Graph::shortest_path", [&] {
+        for (auto &p : pairs)
+            checksum += G.shortest_path(p.first, p.second).first;
+    });
+    measure("Graph::astar", [&] {
+        for (auto &p : pairs)
+            checksum -= G.astar(p.first, p.second, manhattan).first;
+    });
+
+    ShortestPathEngine<int, int> engine(C);
+    size_t dijkstra_reached = 0, astar_reached = 0;
+    measure("ShortestPathEngine::run(src, dst)", [&] {
+        for (auto &p : pairs) {
+            checksum += engine.run(C.id(p.first), C.id(p.second));
+            dijkstra_reached += engine.reached();
+        }
+    });
+    auto by_id = [&](uint32_t u, uint32_t v) { return manhattan(C.vertex_at(u), C.vertex_at(v)); };
+    measure("ShortestPathEngine::run_astar", [&] {
+        for (auto &p : pairs) {
+            checksum -= engine.run_astar(C.id(p.first), C.id(p.second), by_id);
+            astar_reached += engine.reached();
+        }
+    });
+    cout << "  vertices reached: dijkstra " << dijkstra_reached << ", astar " << astar_reached << '\n';
+    cout << "  path lengths agree: " << boolalpha << (checksum == 0) << '\n';
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Wall clock timer reporting milliseconds
+class Timer {
+private:
+    std::chrono::steady_clock::time_point start;
+
+public:
+    Timer() : start(std::chrono::steady_clock::now()) {}
+
+    double ms() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// Runs fn once and prints how long it took
+template <typename function>
+double measure(const std::string &label, function fn) {
+    Timer t;
+    fn();
+    double elapsed = t.ms();
+    std::cout << label << ": " << elapsed << " ms\n";
+    return elapsed;
+}
+
+// Random undirected edge list over vertices 0 .. n - 1 with integer weights in [1, 100]
+inline std::vector<std::tuple<int, int, int>> random_edges(int n, size_t m, unsigned seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> node(0, n - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+    std::vector<std::tuple<int, int, int>> edges;
+    edges.reserve(m);
+    while (edges.size() < m) {
+        int a = node(gen), b = node(gen);
+        if (a != b)
+            edges.emplace_back(a, b, weight(gen));
+    }
+    return edges;
+}
+
+// Grid of width x height vertices, vertex y * width + x linked to its right and lower neighbours,
+// with weights in [10, 30] so that 10 * Manhattan distance never overestimates
+inline std::vector<std::tuple<int, int, int>> grid_edges(int width, int height, unsigned seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> weight(10, 30);
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int u = y * width + x;
+            if (x + 1 < width)
+                edges.emplace_back(u, u + 1, weight(gen));
+            if (y + 1 < height)
+                edges.emplace_back(u, u + width, weight(gen));
+        }
+    }
+    return edges;
+}
+
+// Power-law graph by preferential attachment: every new vertex links to k earlier vertices
+// picked with probability proportional to their degree, weights in [1, 100]
+inline std::vector<std::tuple<int, int, int>> power_law_edges(int n, int k, unsigned seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> weight(1, 100);
+    std::vector<std::tuple<int, int, int>> edges;
+    std::vector<int> endpoints;
+    for (int u = 1; u < n; ++u) {
+        for (int i = 0; i < k && i < u; ++i) {
+            int v = endpoints.empty() ? 0 : endpoints[std::uniform_int_distribution<size_t>(0, endpoints.size() - 1)(gen)];
+            if (v == u)
+                continue;
+            edges.emplace_back(u, v, weight(gen));
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    return edges;
+}
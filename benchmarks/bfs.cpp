@@ -0,0 +1,40 @@
+#include <iostream>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+void compare(const string &name, const vector<tuple<int, int, int>> &edges) {
+    Graph<int, int> G;
+    for (auto &e : edges)
+        G.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    CsrGraph<int, int> C = G.freeze();
+    cout << name << ": " << C.size() << " vertices, " << C.edge_count() / 2 << " edges\n";
+
+    int src = C.vertex_at(0);
+    size_t reached = 0;
+    double base = measure("  Graph::breadth_first_search_iterator", [&] {
+        Graph<int, int>::breadth_first_search_iterator it(G, G.find(src));
+        for (reached = 0; !it.bfsend(); ++it)
+            ++reached;
+    });
+    measure("  CsrGraph::bfs", [&] { reached = C.bfs(src).size(); });
+
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        BreadthFirstTree tree;
+        double t = measure("  CsrGraph::parallel_bfs, " + to_string(threads) + " threads", [&] { tree = C.parallel_bfs(src, threads); });
+        size_t count = 0;
+        for (uint32_t l : tree.level)
+            count += l != CsrGraph<int, int>::npos;
+        cout << "    speedup over iterator " << base / t << ", reached " << count << " of " << reached << '\n';
+    }
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 1000000;
+    compare("power-law", power_law_edges(n, 8));
+    compare("random", random_edges(n, 4 * static_cast<size_t>(n)));
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 1000000;
+    int bc_n = argc > 3 ? stoi(argv[3]) : 2000;
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    cout << "Vertices: " << n << ", edges: " << m << '\n';
+    CsrGraph<int, int> C(edges.begin(), edges.end(), false, true);
+
+    // Push-based PageRank over the adjacency map, as done by hand on exported Graph contents so far
+    Graph<int, int, Direction::directed> G;
+    G.add_edges(edges.begin(), edges.end());
+    double base = measure("push PageRank over Graph", [&] {
+        unordered_map<int, double> rank, next;
+        for (const auto &x : G)
+            rank[x.first] = 1.0 / G.size();
+        for (int round = 0; round < 100; ++round) {
+            double lost = 0, change = 0;
+            for (const auto &x : G)
+                next[x.first] = 0;
+            for (const auto &x : G) {
+                if (x.second.empty())
+                    lost += rank[x.first];
+                for (const auto &y : x.second)
+                    next[y.first] += rank[x.first] / x.second.size();
+            }
+            for (auto &x : next) {
+                x.second = 0.15 / G.size() + 0.85 * (x.second + lost / G.size());
+                change += abs(x.second - rank[x.first]);
+            }
+            rank.swap(next);
+            if (change < 1e-6)
+                break;
+        }
+    });
+
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        double t = measure("CsrGraph::page_rank, " + to_string(threads) + " threads", [&] { C.page_rank(0.85, 1e-6, 100, threads); });
+        cout << "  speedup " << base / t << '\n';
+    }
+
+    vector<tuple<int, int, int>> small = random_edges(bc_n, bc_n * 5);
+    CsrGraph<int, int> S(small.begin(), small.end());
+    cout << "Betweenness on " << bc_n << " vertices, " << small.size() << " edges\n";
+    double single = measure("betweenness_centrality, 1 thread", [&] { S.betweenness_centrality(false, 1); });
+    for (unsigned threads = 2; threads <= hardware; threads *= 2) {
+        double t = measure("betweenness_centrality, " + to_string(threads) + " threads", [&] { S.betweenness_centrality(false, threads); });
+        cout << "  speedup " << single / t << '\n';
+    }
+    measure("betweenness_centrality, weighted", [&] { S.betweenness_centrality(true, 0); });
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 400000;
+    int batches = argc > 3 ? stoi(argv[3]) : 20;
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    cout << "Vertices: " << n << ", edges: " << m << '\n';
+    CsrGraph<int, int> C(edges.begin(), edges.end());
+
+    // Labelling every vertex by repeated breadth first searches, as done by hand so far
+    size_t bfs_components = 0;
+    double base = measure("components by repeated bfs", [&] {
+        vector<bool> seen(C.size(), false);
+        for (uint32_t u = 0; u < C.size(); ++u) {
+            if (seen[u])
+                continue;
+            ++bfs_components;
+            for (int x : C.bfs(C.vertex_at(u)))
+                seen[C.id(x)] = true;
+        }
+    });
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        size_t components = 0;
+        double t = measure("connected_components, " + to_string(threads) + " threads", [&] {
+            vector<uint32_t> label = C.connected_components(threads);
+            for (uint32_t u = 0; u < label.size(); ++u)
+                components += label[u] == u;
+        });
+        cout << "  speedup " << base / t << ", components match: " << boolalpha << (components == bfs_components) << '\n';
+    }
+
+    // One connectivity query after every ingest batch
+    cout << batches << " ingest batches with a query after each\n";
+    size_t step = edges.size() / batches, hits = 0;
+    double rescan = measure("Graph::add_edges + bfs per query", [&] {
+        Graph<int, int> G;
+        for (int b = 0; b < batches; ++b) {
+            G.add_edges(edges.begin() + b * step, edges.begin() + (b + 1) * step);
+            CsrGraph<int, int> S = G.freeze();
+            for (int x : S.bfs(get<0>(edges[0])))
+                hits += x == get<1>(edges[b * step]);
+        }
+    });
+    double incremental = measure("InternedGraph::add_edges + connected", [&] {
+        InternedGraph<int, int> I;
+        for (int b = 0; b < batches; ++b) {
+            I.add_edges(edges.begin() + b * step, edges.begin() + (b + 1) * step);
+            hits -= I.connected(get<0>(edges[0]), get<1>(edges[b * step]));
+        }
+    });
+    cout << "  speedup " << rescan / incremental << "x, checksum " << hits << '\n';
+}
@@ -0,0 +1,76 @@
+#include <atomic>
+#include <iostream>
+#include <shared_mutex>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+// Runs readers on their own threads for a fixed time while the calling thread streams updates, returns queries per second
+template <typename query, typename writer>
+double throughput(unsigned readers, int millis, query q, writer w) {
+    atomic<bool> stop(false);
+    atomic<long> done(0);
+    vector<thread> threads;
+    for (unsigned t = 0; t < readers; ++t)
+        threads.emplace_back([&, t] {
+            long count = 0;
+            for (unsigned i = t; !stop.load(memory_order_relaxed); i += readers, ++count)
+                q(t, i);
+            done += count;
+        });
+    Timer timer;
+    for (unsigned i = 0; timer.ms() < millis; ++i)
+        w(i);
+    stop = true;
+    for (thread &t : threads)
+        t.join();
+    return done.load() * 1000.0 / timer.ms();
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 20000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 100000;
+    int millis = argc > 3 ? stoi(argv[3]) : 1000;
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    vector<tuple<int, int, int>> updates = random_edges(n, 100000, 7);
+    cout << "Vertices: " << n << ", edges: " << m << ", " << millis << " ms per run with a writer streaming updates\n";
+
+    // Baseline: a Graph behind a reader-writer lock, every update taking the lock exclusively
+    Graph<int, int> G;
+    G.add_edges(edges.begin(), edges.end());
+    shared_mutex lock;
+
+    // Updates are committed every 1024 edges
+    ConcurrentGraph<int, int> C(1024);
+    for (const tuple<int, int, int> &e : edges)
+        C.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    C.commit();
+
+    unsigned hardware = max(2u, thread::hardware_concurrency());
+    for (unsigned readers = 1; readers <= hardware; readers *= 2) {
+        double locked = throughput(readers, millis, [&](unsigned, unsigned i) {
+            shared_lock<shared_mutex> guard(lock);
+            G.shortest_path(int(i % n), int((i * 7919) % n));
+        }, [&](unsigned i) {
+            const tuple<int, int, int> &e = updates[i % updates.size()];
+            unique_lock<shared_mutex> guard(lock);
+            G.modify_edge(get<0>(e), get<1>(e), get<2>(e));
+        });
+
+        vector<unique_ptr<ConcurrentGraph<int, int>::reader>> handles;
+        for (unsigned t = 0; t < readers; ++t)
+            handles.emplace_back(new ConcurrentGraph<int, int>::reader(C));
+        double lock_free = throughput(readers, millis, [&](unsigned t, unsigned i) {
+            handles[t]->shortest_path(int(i % n), int((i * 7919) % n));
+        }, [&](unsigned i) {
+            const tuple<int, int, int> &e = updates[i % updates.size()];
+            C.modify_edge(get<0>(e), get<1>(e), get<2>(e));
+        });
+        cout << readers << " readers: " << locked << " queries/s with shared_mutex, " << lock_free << " queries/s lock-free, speedup "
+             << lock_free / locked << "x\n";
+    }
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? stoul(argv[2]) : 1000000;
+
+    cout << "Vertices: " << n << ", edges: " << m << '\n';
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+
+    Graph<int, int> G;
+    for (auto &e : edges)
+        G.add_edge(get<0>(e), get<1>(e), get<2>(e));
+
+    CsrGraph<int, int> C;
+    measure("freeze", [&] { C = G.freeze(); });
+
+    int src = get<0>(edges.front());
+    size_t visited = 0;
+
+    measure("Graph bfs iterator", [&] {
+        Graph<int, int>::breadth_first_search_iterator it(G, G.find(src));
+        visited = 0;
+        while (!it.bfsend()) {
+            ++visited;
+            ++it;
+        }
+    });
+    measure("CsrGraph bfs", [&] { visited = C.bfs(src).size(); });
+    cout << "  reached " << visited << " vertices\n";
+
+    measure("Graph dfs iterator", [&] {
+        Graph<int, int>::depth_first_search_iterator it(G, G.find(src));
+        while (!it.dfsend())
+            ++it;
+    });
+    measure("CsrGraph dfs", [&] { C.dfs(src); });
+
+    map<int, pair<int, int>> d1, d2;
+    measure("Graph dijkstra", [&] { d1 = G.dijkstra(src); });
+    measure("CsrGraph dijkstra", [&] { d2 = C.dijkstra(src); });
+
+    bool same = d1.size() == d2.size();
+    for (auto &x : d1)
+        same = same && d2[x.first].second == x.second.second;
+    cout << "  distances match: " << boolalpha << same << '\n';
+}
@@ -0,0 +1,38 @@
+#include <iostream>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+void compare(const string &name, const vector<tuple<int, int, int>> &edges) {
+    Graph<int, int> G;
+    for (auto &e : edges)
+        G.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    CsrGraph<int, int> C = G.freeze();
+    cout << name << ": " << C.size() << " vertices, " << C.edge_count() / 2 << " edges\n";
+
+    int src = C.vertex_at(0);
+    ShortestPathTree<int> reference;
+    double base = measure("  sequential dijkstra", [&] { reference = C.shortest_paths(src); });
+
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (int delta : {0, 10, 50, 200}) {
+        for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+            ShortestPathTree<int> tree;
+            double t = measure("  delta_stepping, delta " + (delta ? to_string(delta) : string("auto")) + ", " + to_string(threads) + " threads",
+                               [&] { tree = C.delta_stepping(src, delta, threads); });
+            cout << "    speedup " << base / t << ", distances match: " << boolalpha << (tree.distance == reference.distance) << '\n';
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 500000;
+    compare("power-law", power_law_edges(n, 5));
+    int side = 1;
+    while ((side + 1) * (side + 1) <= n)
+        ++side;
+    compare("grid", grid_edges(side, side));
+}
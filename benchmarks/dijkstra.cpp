@@ -0,0 +1,70 @@
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? stoul(argv[2]) : 1000000;
+    int queries = argc > 3 ? stoi(argv[3]) : 20;
+
+    cout << "Vertices: " << n << ", edges: " << m << ", sources: " << queries << '\n';
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+
+    Graph<int, int> G;
+    for (auto &e : edges)
+        G.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    CsrGraph<int, int> C = G.freeze();
+
+    vector<int> sources;
+    for (int i = 0; i < queries; ++i)
+        sources.push_back(get<0>(edges[i]));
+
+    long long checksum = 0;
+    measure("Graph::dijkstra (map)", [&] {
+        for (int s : sources)
+            checksum += G.dijkstra(s).size();
+    });
+    measure("CsrGraph::dijkstra (map adapter)", [&] {
+        for (int s : sources)
+            checksum += C.dijkstra(s).size();
+    });
+    measure("CsrGraph::shortest_paths (flat)", [&] {
+        for (int s : sources)
+            checksum += C.shortest_paths(s).distance.size();
+    });
+    measure("ShortestPathEngine (reused scratch)", [&] {
+        ShortestPathEngine<int, int> engine(C);
+        for (int s : sources) {
+            engine.run(C.id(s));
+            checksum += engine.result().distance.size();
+        }
+    });
+
+    // Point to point queries between random pairs
+    vector<pair<int, int>> pairs;
+    for (int i = 0; i < queries; ++i)
+        pairs.emplace_back(get<0>(edges[i]), get<1>(edges[m - 1 - i]));
+
+    measure("Graph::shortest_path", [&] {
+        for (auto &p : pairs)
+            checksum += G.shortest_path(p.first, p.second).first;
+    });
+    measure("Graph::shortest_path (bidirectional)", [&] {
+        for (auto &p : pairs)
+            checksum += G.shortest_path(p.first, p.second, true).first;
+    });
+    measure("ShortestPathEngine::run(src, dst)", [&] {
+        ShortestPathEngine<int, int> engine(C);
+        for (auto &p : pairs)
+            checksum += engine.run(C.id(p.first), C.id(p.second));
+    });
+    measure("ShortestPathEngine::run_bidirectional", [&] {
+        ShortestPathEngine<int, int> engine(C);
+        for (auto &p : pairs)
+            checksum += engine.run_bidirectional(C.id(p.first), C.id(p.second));
+    });
+    cout << "  checksum " << checksum << '\n';
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 20000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 100000;
+    int queries = argc > 3 ? stoi(argv[3]) : 200;
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    cout << "Directed graph: " << n << " vertices, " << m << " edges, " << queries << " queries\n";
+
+    Graph<int, int, Direction::directed> D;
+    Graph<int, int, Direction::bidirectional> B;
+    measure("add_edges directed", [&] { D.add_edges(edges.begin(), edges.end()); });
+    measure("add_edges bidirectional", [&] { B.add_edges(edges.begin(), edges.end()); });
+
+    // Without a reverse index the edges entering a vertex can only be found by scanning every vertex
+    size_t found = 0;
+    double scan = measure("predecessors by scanning", [&] {
+        for (int q = 0; q < queries; ++q) {
+            for (Graph<int, int, Direction::directed>::list_type &x : D) {
+                for (const pair<int, int> &y : x.second)
+                    found += y.first == q;
+            }
+        }
+    });
+    double index = measure("predecessors from the reverse index", [&] {
+        for (int q = 0; q < queries; ++q)
+            found -= B.predecessors(q).size();
+    });
+    cout << "  speedup " << scan / index << "x, checksum " << found << '\n';
+
+    CsrGraph<int, int> C = B.freeze();
+    size_t reached = 0;
+    measure("CsrGraph::bfs reverse x" + to_string(queries), [&] {
+        for (int q = 0; q < queries; ++q)
+            reached += C.bfs(q, true).size();
+    });
+    double one = measure("shortest_path directed", [&] {
+        for (int q = 0; q < queries; ++q)
+            reached += D.shortest_path(q, n - 1 - q).second.size();
+    });
+    double two = measure("shortest_path bidirectional", [&] {
+        for (int q = 0; q < queries; ++q)
+            reached += B.shortest_path(q, n - 1 - q, true).second.size();
+    });
+    cout << "  speedup " << one / two << "x, checksum " << reached << '\n';
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int width = argc > 1 ? stoi(argv[1]) : 300;
+    int changes = argc > 2 ? stoi(argv[2]) : 50;
+
+    // Road network stand-in: a grid whose edge weights change like traffic, up or down by up to half
+    vector<tuple<int, int, int>> edges = grid_edges(width, width);
+    cout << "Grid " << width << " x " << width << ", " << changes << " weight changes\n";
+    mt19937 gen(7);
+    vector<tuple<int, int, int>> updates;
+    for (int i = 0; i < changes; ++i) {
+        const tuple<int, int, int> &e = edges[gen() % edges.size()];
+        updates.emplace_back(get<0>(e), get<1>(e), get<2>(e) / 2 + int(gen() % get<2>(e)));
+    }
+
+    Graph<int, int> G;
+    G.add_edges(edges.begin(), edges.end());
+    long long sum = 0;
+    double full = measure("modify_edge + dijkstra from scratch", [&] {
+        for (const tuple<int, int, int> &u : updates) {
+            G.modify_edge(get<0>(u), get<1>(u), get<2>(u));
+            sum += G.dijkstra(0)[width * width - 1].second;
+        }
+    });
+
+    Graph<int, int> H;
+    H.add_edges(edges.begin(), edges.end());
+    DynamicShortestPaths<int, int> tree(H, 0);
+    size_t affected = 0;
+    double incremental = measure("DynamicShortestPaths::modify_edge", [&] {
+        for (const tuple<int, int, int> &u : updates) {
+            tree.modify_edge(get<0>(u), get<1>(u), get<2>(u));
+            sum -= tree.distance(width * width - 1);
+            affected += tree.last_affected();
+        }
+    });
+    cout << "  " << 100.0 * affected / changes / (width * width) << "% of vertices affected per change, speedup " << full / incremental
+         << "x, checksum " << sum << '\n';
+}
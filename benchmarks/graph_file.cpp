@@ -0,0 +1,32 @@
+#include <cstdio>
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 1000000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 5000000;
+    string path = argc > 3 ? argv[3] : "graph_file_bench.bin";
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    cout << "Graph: " << n << " vertices, " << m << " edges\n";
+
+    CsrGraph<int, int> C1;
+    double build = measure("build snapshot from edge list", [&] { C1 = CsrGraph<int, int>(edges.begin(), edges.end()); });
+    measure("save", [&] { C1.save(path); });
+
+    CsrGraph<int, int> C2;
+    double load = measure("load (mmap)", [&] { C2 = CsrGraph<int, int>::load(path); });
+    cout << "  startup speedup " << build / load << "x\n";
+    double trusted = measure("load (mmap, no validation)", [&] { C2 = CsrGraph<int, int>::load(path, false); });
+    cout << "  startup speedup " << build / trusted << "x\n";
+
+    long long sum = 0;
+    measure("first query on the mapped snapshot", [&] { sum += C2.shortest_path(0, n - 1).first; });
+    measure("same query on the built snapshot", [&] { sum -= C1.shortest_path(0, n - 1).first; });
+    cout << "  checksum " << sum << '\n';
+    remove(path.c_str());
+}
@@ -0,0 +1,34 @@
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 1000000;
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    cout << "Graph: " << n << " vertices, " << m << " edges\n";
+
+    Graph<int, int> G1;
+    double single = measure("Graph::add_edge per edge", [&] {
+        for (const tuple<int, int, int> &e : edges)
+            G1.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    });
+
+    Graph<int, int> G2;
+    double batch = measure("Graph::add_edges", [&] { G2.add_edges(edges.begin(), edges.end()); });
+    cout << "  speedup " << single / batch << "x\n";
+
+    CsrGraph<int, int> C1;
+    double frozen = measure("Graph::add_edges + freeze", [&] {
+        Graph<int, int> G3;
+        G3.add_edges(edges.begin(), edges.end());
+        C1 = G3.freeze();
+    });
+    CsrGraph<int, int> C2;
+    double direct = measure("CsrGraph from edge list", [&] { C2 = CsrGraph<int, int>(edges.begin(), edges.end()); });
+    cout << "  speedup " << frozen / direct << "x, " << C1.edge_count() << " == " << C2.edge_count() << " adjacency entries\n";
+}
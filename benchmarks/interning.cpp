@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 50000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 250000;
+
+    // Long keys, as with URLs or user names, so every copy and compare is expensive
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    vector<string> names(n);
+    for (int i = 0; i < n; ++i)
+        names[i] = "https://example.org/vertex/" + to_string(i);
+    cout << "Graph: " << n << " vertices, " << m << " edges\n";
+
+    Graph<string, int> G;
+    InternedGraph<string, int> I;
+    double plain = measure("build Graph<string, int>", [&] {
+        for (const tuple<int, int, int> &e : edges)
+            G.add_edge(names[get<0>(e)], names[get<1>(e)], get<2>(e));
+    });
+    double interned = measure("build InternedGraph<string, int>", [&] {
+        for (const tuple<int, int, int> &e : edges)
+            I.add_edge(names[get<0>(e)], names[get<1>(e)], get<2>(e));
+    });
+    cout << "  build speedup " << plain / interned << "x\n";
+
+    long long sum = 0;
+    plain = measure("Graph<string, int>::shortest_path x100", [&] {
+        for (int i = 0; i < 100; ++i)
+            sum += G.shortest_path(names[i], names[n - 1 - i]).first;
+    });
+    interned = measure("InternedGraph<string, int>::shortest_path x100", [&] {
+        for (int i = 0; i < 100; ++i)
+            sum -= I.shortest_path(names[i], names[n - 1 - i]).first;
+    });
+    cout << "  query speedup " << plain / interned << "x, checksum " << sum << '\n';
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? stoul(argv[2]) : 1000000;
+    int queries = argc > 3 ? stoi(argv[3]) : 20;
+    size_t k = argc > 4 ? stoul(argv[4]) : 10;
+
+    cout << "Vertices: " << n << ", edges: " << m << ", sources: " << queries << ", nearest: " << k << '\n';
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    Graph<int, int> G;
+    G.add_edges(edges.begin(), edges.end());
+
+    // The k nearest vertices, read off the full result so far
+    long long checksum = 0;
+    double full = measure("Graph::dijkstra, then sort by distance", [&] {
+        for (int i = 0; i < queries; ++i) {
+            map<int, pair<int, int>> tree = G.dijkstra(get<0>(edges[i]));
+            vector<pair<int, int>> nearest;
+            for (const auto &x : tree)
+                nearest.emplace_back(x.second.second, x.first);
+            partial_sort(nearest.begin(), nearest.begin() + min(k, nearest.size()), nearest.end());
+            for (size_t j = 0; j < k && j < nearest.size(); ++j)
+                checksum += nearest[j].first;
+        }
+    });
+    double lazy = measure("Graph::dijkstra_settled, first k", [&] {
+        for (int i = 0; i < queries; ++i) {
+            size_t j = 0;
+            for (const pair<int, int> &x : G.dijkstra_settled(get<0>(edges[i]))) {
+                if (j++ == k)
+                    break;
+                checksum -= x.second;
+            }
+        }
+    });
+    cout << "  speedup " << full / lazy << "x, checksum " << checksum << '\n';
+
+    size_t reached = 0;
+    measure("Graph::bfs, first k", [&] {
+        for (int i = 0; i < queries; ++i) {
+            size_t j = 0;
+            for (int v : G.bfs(get<0>(edges[i]))) {
+                if (j++ == k)
+                    break;
+                reached += v >= 0;
+            }
+        }
+    });
+    cout << "  " << reached << " vertices read\n";
+}
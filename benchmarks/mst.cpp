@@ -0,0 +1,27 @@
+#include <iostream>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 500000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 4000000;
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    cout << "Vertices: " << n << ", edges: " << m << '\n';
+    CsrGraph<int, int> C(edges.begin(), edges.end());
+
+    SpanningTree<int> kruskal;
+    double base = measure("Kruskal", [&] { kruskal = C.minimum_spanning_tree(); });
+    cout << "  " << kruskal.edges.size() << " tree edges, weight " << kruskal.weight << '\n';
+
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        SpanningTree<int> boruvka;
+        double t = measure("Boruvka, " + to_string(threads) + " threads", [&] { boruvka = C.parallel_minimum_spanning_tree(threads); });
+        cout << "  speedup " << base / t << ", same weight: " << boolalpha << (boruvka.weight == kruskal.weight) << '\n';
+    }
+}
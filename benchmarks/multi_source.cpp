@@ -0,0 +1,41 @@
+#include <iostream>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 100000;
+    size_t m = argc > 2 ? stoul(argv[2]) : 500000;
+    int sources = argc > 3 ? stoi(argv[3]) : 64;
+
+    cout << "Vertices: " << n << ", edges: " << m << ", sources: " << sources << '\n';
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+
+    Graph<int, int> G;
+    for (auto &e : edges)
+        G.add_edge(get<0>(e), get<1>(e), get<2>(e));
+    CsrGraph<int, int> C = G.freeze();
+
+    vector<int> src;
+    for (int i = 0; i < sources; ++i)
+        src.push_back(C.vertex_at(i));
+
+    vector<ShortestPathTree<int>> sequential;
+    double base = measure("sequential shortest_paths", [&] {
+        for (int s : src)
+            sequential.push_back(C.shortest_paths(s));
+    });
+
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        vector<ShortestPathTree<int>> parallel;
+        double t = measure("parallel shortest_paths, " + to_string(threads) + " threads", [&] { parallel = C.shortest_paths(src, threads); });
+        bool same = true;
+        for (int i = 0; i < sources; ++i)
+            same = same && parallel[i].distance == sequential[i].distance;
+        cout << "  speedup " << base / t << ", results match: " << boolalpha << same << '\n';
+    }
+}
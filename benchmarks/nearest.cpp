@@ -0,0 +1,64 @@
+#include <iostream>
+#include <thread>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 200000;
+    size_t m = argc > 2 ? stoul(argv[2]) : 1000000;
+    int queries = argc > 3 ? stoi(argv[3]) : 1000;
+    size_t k = argc > 4 ? stoul(argv[4]) : 10;
+    int radius = argc > 5 ? stoi(argv[5]) : 30;
+
+    cout << "Vertices: " << n << ", edges: " << m << ", queries: " << queries << ", k: " << k << ", radius: " << radius << '\n';
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    Graph<int, int> G;
+    G.add_edges(edges.begin(), edges.end());
+    CsrGraph<int, int> C = G.freeze();
+
+    vector<int> sources;
+    for (int i = 0; i < queries; ++i)
+        sources.push_back(get<0>(edges[i]));
+
+    // Whole graph search, filtered afterwards, as done so far; only a few sources, it is slow
+    int full_queries = min(queries, 10);
+    long long checksum = 0;
+    double full = measure("CsrGraph::dijkstra + filter, " + to_string(full_queries) + " queries", [&] {
+        for (int i = 0; i < full_queries; ++i) {
+            vector<int> d;
+            for (const auto &x : C.dijkstra(sources[i])) {
+                if (x.second.second <= radius)
+                    d.push_back(x.second.second);
+            }
+            sort(d.begin(), d.end());
+            for (size_t j = 0; j < k && j < d.size(); ++j)
+                checksum += d[j];
+        }
+    }) / full_queries;
+
+    double single = measure("ShortestPathEngine::run_nearest", [&] {
+        ShortestPathEngine<int, int> engine(C);
+        for (int s : sources) {
+            for (const pair<uint32_t, int> &x : engine.run_nearest(C.id(s), k, radius))
+                checksum -= x.second;
+        }
+    }) / queries;
+    cout << "  per query " << single * 1000 << " us, speedup " << full / single << "x\n";
+
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        double batch = measure("CsrGraph::nearest batch, " + to_string(threads) + " threads", [&] {
+            for (const vector<pair<int, int>> &found : C.nearest(sources, k, radius, threads))
+                checksum += found.size();
+        }) / queries;
+        cout << "  per query " << batch * 1000 << " us\n";
+    }
+    measure("Graph::nearest", [&] {
+        for (int s : sources)
+            checksum += G.nearest(s, k, radius).size();
+    });
+    cout << "checksum " << checksum << '\n';
+}
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? stoi(argv[1]) : 1000000;
+    size_t m = argc > 2 ? stoull(argv[2]) : 5000000;
+    unsigned threads = argc > 3 ? stoi(argv[3]) : 0;
+    string path = "reader_bench.gr";
+
+    vector<tuple<int, int, int>> edges = random_edges(n, m);
+    {
+        ofstream out(path);
+        out << "p sp " << n << ' ' << m << '\n';
+        for (const tuple<int, int, int> &e : edges)
+            out << "a " << get<0>(e) << ' ' << get<1>(e) << ' ' << get<2>(e) << '\n';
+    }
+    cout << "DIMACS file: " << n << " vertices, " << m << " arcs\n";
+
+    size_t count = 0;
+    double stream = measure("ifstream >>", [&] {
+        ifstream in(path);
+        string tag, line;
+        int u, v, w;
+        getline(in, line);
+        while (in >> tag >> u >> v >> w)
+            ++count;
+    });
+    double serial = measure("GraphReader, 1 thread", [&] {
+        GraphReader<int, int> reader(path, GraphFormat::dimacs);
+        vector<tuple<int, int, int>> chunk;
+        while (reader.next(chunk))
+            count -= chunk.size();
+    });
+    double parallel = measure("GraphReader, all threads", [&] {
+        GraphReader<int, int> reader(path, GraphFormat::dimacs, threads);
+        vector<tuple<int, int, int>> chunk;
+        while (reader.next(chunk))
+            count += chunk.size();
+    });
+    cout << "  speedup " << stream / serial << "x serial, " << stream / parallel << "x parallel, " << count << " arcs\n";
+    remove(path.c_str());
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+// Hardware cache miss counter of the calling thread, unavailable without perf event access
+class CacheMisses {
+private:
+    int fd;
+
+public:
+    CacheMisses() : fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMisses() {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    // Runs fn and returns the cache misses it caused, or -1 if they cannot be counted
+    template <typename function>
+    long long count(function fn) {
+        long long misses = -1;
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            fn();
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+                misses = -1;
+            return misses;
+        }
+#endif
+        fn();
+        return misses;
+    }
+};
+
+// Mean distance between the ids of the two ends of an edge
+double mean_gap(const CsrGraph<int, int> &C) {
+    double sum = 0;
+    for (uint32_t u = 0; u < C.size(); ++u) {
+        for (size_t e = C.edge_begin(u); e < C.edge_end(u); ++e)
+            sum += C.target(e) > u ? C.target(e) - u : u - C.target(e);
+    }
+    return sum / max<size_t>(C.edge_count(), 1);
+}
+
+void run(const string &name, const CsrGraph<int, int> &C, const vector<int> &sources) {
+    CacheMisses counter;
+    uint32_t checksum = 0;
+    cout << name << ": mean id gap " << mean_gap(C) << '\n';
+    auto report = [&](const string &label, auto fn) {
+        Timer t;
+        long long misses = counter.count(fn);
+        cout << "  " << label << ": " << t.ms() << " ms, cache misses " << (misses < 0 ? string("n/a") : to_string(misses)) << '\n';
+    };
+    report("bfs", [&] {
+        for (int s : sources)
+            checksum += C.parallel_bfs(s, 1).level.back();
+    });
+    report("dijkstra", [&] {
+        ShortestPathEngine<int, int> engine(C);
+        for (int s : sources) {
+            engine.run(C.id(s));
+            checksum += engine.reached();
+        }
+    });
+    report("page_rank", [&] { checksum += C.page_rank(0.85, 1e-6, 100, 1).size(); });
+    if (checksum == 0)
+        cout << '\n';
+}
+
+void compare(const string &name, const vector<tuple<int, int, int>> &edges, int queries) {
+    Graph<int, int> G;
+    G.add_edges(edges.begin(), edges.end());
+    CsrGraph<int, int> C = G.freeze();
+    vector<int> sources;
+    for (int i = 0; i < queries; ++i)
+        sources.push_back(get<0>(edges[i * 7919 % edges.size()]));
+
+    cout << "--- " << name << ", " << C.size() << " vertices, " << edges.size() << " edges\n";
+    run("freeze() order", C, sources);
+    CsrGraph<int, int> R;
+    measure("reorder(reverse_cuthill_mckee)", [&] { R = C.reorder(VertexOrder::reverse_cuthill_mckee); });
+    run("reverse Cuthill-McKee", R, sources);
+    measure("reorder(degree)", [&] { R = C.reorder(VertexOrder::degree); });
+    run("degree", R, sources);
+    measure("reorder(breadth_first)", [&] { R = C.reorder(VertexOrder::breadth_first); });
+    run("breadth first", R, sources);
+}
+
+int main(int argc, char **argv) {
+    int side = argc > 1 ? stoi(argv[1]) : 700;
+    int n = argc > 2 ? stoi(argv[2]) : 500000;
+    size_t m = argc > 3 ? stoull(argv[3]) : 4000000;
+    int queries = argc > 4 ? stoi(argv[4]) : 10;
+
+    // Road network: a grid whose vertex ids were handed out in random order, as by an external id scheme
+    vector<tuple<int, int, int>> road = grid_edges(side, side);
+    vector<int> label(side * side);
+    iota(label.begin(), label.end(), 0);
+    shuffle(label.begin(), label.end(), mt19937(7));
+    for (tuple<int, int, int> &e : road) {
+        get<0>(e) = label[get<0>(e)];
+        get<1>(e) = label[get<1>(e)];
+    }
+    compare("road", road, queries);
+
+    // Social network: skewed endpoints give a few hubs and many vertices of low degree
+    mt19937 gen(42);
+    uniform_real_distribution<double> unit(0, 1);
+    vector<tuple<int, int, int>> social;
+    social.reserve(m);
+    while (social.size() < m) {
+        int a = static_cast<int>(n * pow(unit(gen), 3)), b = static_cast<int>(n * unit(gen));
+        if (a != b)
+            social.emplace_back(a * 2654435761u % n, b, 1 + static_cast<int>(gen() % 100));
+    }
+    compare("social", social, queries);
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+
+#include "../src/graph.h"
+#include "bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    int components = argc > 1 ? stoi(argv[1]) : 100000;
+    int size = argc > 2 ? stoi(argv[2]) : 8;
+
+    // Many small rings, so every traversal is short and setup cost dominates
+    Graph<int, int> G;
+    for (int c = 0; c < components; ++c)
+        for (int i = 0; i < size; ++i)
+            G.add_edge(c * size + i, c * size + (i + 1) % size, 1);
+    cout << "Traversals: " << components << " of " << size << " vertices each\n";
+
+    long long sum = 0;
+    measure("bfs, fresh iterator per traversal", [&] {
+        for (int c = 0; c < components; ++c)
+            for (Graph<int, int>::breadth_first_search_iterator it(G, G.find(c * size)); !it.bfsend(); ++it)
+                sum += it->first;
+    });
+    measure("bfs, reused traversal_context", [&] {
+        Graph<int, int>::traversal_context ctx;
+        for (int c = 0; c < components; ++c)
+            for (Graph<int, int>::breadth_first_search_iterator it(G, G.find(c * size), ctx); !it.bfsend(); ++it)
+                sum -= it->first;
+    });
+    measure("dfs, fresh iterator per traversal", [&] {
+        for (int c = 0; c < components; ++c)
+            for (Graph<int, int>::depth_first_search_iterator it(G, G.find(c * size)); !it.dfsend(); ++it)
+                sum += it->first;
+    });
+    measure("dfs, reused traversal_context", [&] {
+        Graph<int, int>::traversal_context ctx;
+        for (int c = 0; c < components; ++c)
+            for (Graph<int, int>::depth_first_search_iterator it(G, G.find(c * size), ctx); !it.dfsend(); ++it)
+                sum -= it->first;
+    });
+    cout << "  checksum " << sum << '\n';
+}
@@ -4,6 +4,8 @@
 #include <stack>
 #include <string>
 
+// Print every edge as it is added
+#define GRAPH_LOGGING 1
 #include "../src/graph.h"
 
 using namespace std;
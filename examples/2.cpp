@@ -1,9 +1,10 @@
 #include <algorithm>
 #include <iostream>
-#include <numeric>
 #include <stack>
 #include <string>
 
+// Print every edge as it is added
+#define GRAPH_LOGGING 1
 #include "../src/graph.h"
 
 using namespace std;
@@ -115,12 +116,9 @@ int main() {
     cout << "MAX EDGE is between " << src << " and " << dest << " with weight " << max << '\n';
 
     // ACCUMULATE
-    Graph<int, int>::breadth_first_search_iterator bfsacc1(G2, G2.find(0));
-    Graph<int, int>::breadth_first_search_iterator bfsacc2(G2, G2.find(0));
-    while (!bfsacc2.bfsend())
-        ++bfsacc2;
-
-    int ele = accumulate(bfsacc1, bfsacc2, 0, [](int x, auto y) { return x + y.first; });
+    int ele = 0;
+    for (int node : G2.bfs(0))
+        ele += node;
     cout << "ACCUMULATE SUM OF NODES : " << ele << '\n';
 
     // CYCLE CHECK
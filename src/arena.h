@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Monotonic memory resource for graphs that are built, queried and thrown away as a whole.
+// Allocation bumps a pointer, deallocation does nothing, and reset() rewinds to the start while
+// keeping the blocks, so a scratch graph rebuilt per request stops allocating once the arena has
+// grown to the largest one. Not thread-safe.
+class GraphArena : public std::pmr::memory_resource {
+private:
+    struct block {
+        std::unique_ptr<std::max_align_t[]> memory;
+        size_t size;
+    };
+
+    std::vector<block> blocks;
+
+    // Allocations are served from blocks[current] starting at offset
+    size_t current;
+    size_t offset;
+    size_t next_size;
+    size_t used;
+
+    void *do_allocate(size_t, size_t) override;
+    void do_deallocate(void *, size_t, size_t) override;
+    bool do_is_equal(const std::pmr::memory_resource &) const noexcept override;
+
+public:
+    explicit GraphArena(size_t = 1 << 16);
+    GraphArena(const GraphArena &) = delete;
+    GraphArena &operator=(const GraphArena &) = delete;
+
+    void reset();
+    void release();
+    size_t bytes_used() const;
+    size_t bytes_reserved() const;
+};
+
+/**
+ * Constructs an arena that allocates no memory until first used.
+ *
+ * @param initial_size The size in bytes of the first block, later blocks double in size.
+ */
+inline GraphArena::GraphArena(size_t initial_size) : current(0), offset(0), next_size(std::max<size_t>(initial_size, 256)), used(0) {}
+
+/**
+ * Carves an allocation out of the current block, moving on to the next block or adding a new one
+ * when it does not fit.
+ *
+ * @param bytes The size of the allocation.
+ * @param alignment The alignment of the allocation.
+ *
+ * @return Pointer to the allocated memory.
+ */
+inline void *GraphArena::do_allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        if (current < blocks.size()) {
+            char *base = reinterpret_cast<char *>(blocks[current].memory.get());
+            uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+            size_t start = offset + ((alignment - address % alignment) % alignment);
+            if (start + bytes <= blocks[current].size) {
+                offset = start + bytes;
+                used += bytes;
+                return base + start;
+            }
+            if (current + 1 < blocks.size()) {
+                ++current;
+                offset = 0;
+                continue;
+            }
+        }
+
+        size_t size = std::max(next_size, bytes + alignment);
+        next_size = size * 2;
+        blocks.push_back(block{std::unique_ptr<std::max_align_t[]>(new std::max_align_t[(size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]), size});
+        current = blocks.size() - 1;
+        offset = 0;
+    }
+}
+
+/**
+ * Does nothing, memory is only given back by reset() and release().
+ *
+ * @return void
+ */
+inline void GraphArena::do_deallocate(void *, size_t, size_t) {}
+
+/**
+ * Checks if memory allocated from another resource can be deallocated by this one.
+ *
+ * @param other The resource to compare with.
+ *
+ * @return true only for the arena itself.
+ */
+inline bool GraphArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+/**
+ * Makes all memory of the arena available again without freeing its blocks.
+ * Every container allocating from the arena must have been destroyed.
+ *
+ * @return void
+ */
+inline void GraphArena::reset() {
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+/**
+ * Frees every block of the arena.
+ * Every container allocating from the arena must have been destroyed.
+ *
+ * @return void
+ */
+inline void GraphArena::release() {
+    blocks.clear();
+    reset();
+}
+
+/**
+ * Returns the number of bytes handed out since the last reset.
+ *
+ * @return The bytes in use.
+ */
+inline size_t GraphArena::bytes_used() const {
+    return used;
+}
+
+/**
+ * Returns the total size of the blocks held by the arena.
+ *
+ * @return The bytes reserved from the system.
+ */
+inline size_t GraphArena::bytes_reserved() const {
+    size_t total = 0;
+    for (const block &b : blocks)
+        total += b.size;
+    return total;
+}
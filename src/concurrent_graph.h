@@ -0,0 +1,344 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+
+// Graph shared by many reader threads and updated in batches by writer threads.
+// Readers query an immutable CsrGraph snapshot without taking locks: a reader announces the epoch it
+// started in, loads the current snapshot and works on it. Writers queue updates; commit() applies the
+// queue to a private Graph, freezes a new snapshot and swaps it in, and an old snapshot is deleted once
+// every reader that could still see it has finished (epoch-based reclamation).
+template <typename vertex = int,                         // ConcurrentGraph::vertex_type
+          typename edge = double,                        // ConcurrentGraph::edge_type
+          Direction direction = Direction::undirected    // ConcurrentGraph::orientation
+          >
+class ConcurrentGraph {
+public:
+    typedef vertex vertex_type;
+    typedef edge edge_type;
+    typedef CsrGraph<vertex, edge> snapshot_type;
+    typedef size_t size_type;
+
+    class reader;
+
+private:
+    enum class update_kind { add, remove, modify };
+
+    struct update {
+        update_kind kind;
+        vertex node1;
+        vertex node2;
+        edge weight;
+    };
+
+    // Epoch a reader is working in, 0 while idle; one cache line per slot so readers never share one
+    struct alignas(64) reader_slot {
+        std::atomic<uint64_t> epoch;
+        std::atomic<bool> claimed;
+    };
+
+    std::atomic<const snapshot_type *> current;
+    std::atomic<uint64_t> epoch;
+    std::unique_ptr<reader_slot[]> slots;
+    size_type slot_count;
+
+    // Writer state, guarded by mutex
+    std::mutex mutex;
+    Graph<vertex, edge, direction> network;
+    std::vector<update> pending;
+    size_type batch_size;
+
+    // Snapshots replaced at the given epoch, deleted once no reader is pinned to an earlier one
+    std::vector<std::pair<uint64_t, std::unique_ptr<const snapshot_type>>> retired;
+
+    void enqueue(update_kind, const vertex &, const vertex &, const edge &);
+    void apply();
+    void reclaim();
+
+public:
+    explicit ConcurrentGraph(size_type = 1024, size_type = 64);
+    ~ConcurrentGraph();
+    ConcurrentGraph(const ConcurrentGraph &) = delete;
+    ConcurrentGraph &operator=(const ConcurrentGraph &) = delete;
+
+    void add_edge(const vertex &, const vertex &, const edge = edge_type());
+    void delete_edge(const vertex &, const vertex &);
+    void modify_edge(const vertex &, const vertex &, const edge = edge_type());
+    void commit();
+    size_type pending_updates();
+    uint64_t version() const;
+
+    // Lock-free read access for one thread at a time, claiming one reader slot for its lifetime
+    class reader {
+    private:
+        ConcurrentGraph<vertex, edge, direction> &owner;
+        size_type slot;
+
+    public:
+        explicit reader(ConcurrentGraph<vertex, edge, direction> &);
+        ~reader();
+        reader(const reader &) = delete;
+        reader &operator=(const reader &) = delete;
+
+        template <typename function>
+        auto read(function fn) -> decltype(fn(std::declval<const snapshot_type &>()));
+        std::pair<edge, std::vector<vertex>> shortest_path(const vertex &, const vertex &, bool = false);
+        bool has_vertex(const vertex &);
+    };
+};
+
+/**
+ * Constructs an empty graph whose first snapshot is empty.
+ *
+ * @param batch The number of queued updates that makes a writer commit on its own, 0 to only commit explicitly.
+ * @param readers The number of reader objects that can exist at the same time.
+ */
+template <typename vertex, typename edge, Direction direction>
+ConcurrentGraph<vertex, edge, direction>::ConcurrentGraph(size_type batch, size_type readers)
+    : current(new snapshot_type()), epoch(1), slots(new reader_slot[readers]), slot_count(readers), batch_size(batch) {
+    for (size_type i = 0; i < slot_count; ++i) {
+        slots[i].epoch.store(0, std::memory_order_relaxed);
+        slots[i].claimed.store(false, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Deletes every snapshot. No reader may be alive.
+ */
+template <typename vertex, typename edge, Direction direction>
+ConcurrentGraph<vertex, edge, direction>::~ConcurrentGraph() {
+    delete current.load();
+}
+
+/**
+ * Queues an update and commits the queue once it reaches the batch size.
+ *
+ * @param kind The kind of update.
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ * @param weight The weight of added or modified edges.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void ConcurrentGraph<vertex, edge, direction>::enqueue(update_kind kind, const vertex &node1, const vertex &node2, const edge &weight) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(update{kind, node1, node2, weight});
+    if (batch_size != 0 && pending.size() >= batch_size)
+        apply();
+}
+
+/**
+ * Queues an edge to be added with the next commit.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ * @param weight The weight of the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void ConcurrentGraph<vertex, edge, direction>::add_edge(const vertex &node1, const vertex &node2, const edge weight) {
+    enqueue(update_kind::add, node1, node2, weight);
+}
+
+/**
+ * Queues an edge to be deleted with the next commit.
+ *
+ * @param node1 The first node of the edge to be deleted.
+ * @param node2 The second node of the edge to be deleted.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void ConcurrentGraph<vertex, edge, direction>::delete_edge(const vertex &node1, const vertex &node2) {
+    enqueue(update_kind::remove, node1, node2, edge());
+}
+
+/**
+ * Queues a change of edge weight, or an edge to be added, with the next commit.
+ *
+ * @param node1 The first node of the edge to be modified.
+ * @param node2 The second node of the edge to be modified.
+ * @param new_weight The new weight for the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void ConcurrentGraph<vertex, edge, direction>::modify_edge(const vertex &node1, const vertex &node2, const edge new_weight) {
+    enqueue(update_kind::modify, node1, node2, new_weight);
+}
+
+/**
+ * Applies every queued update and publishes a new snapshot, which readers starting afterwards see.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void ConcurrentGraph<vertex, edge, direction>::commit() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pending.empty())
+        apply();
+}
+
+/**
+ * Applies the queued updates in order, runs of additions with one add_edges call, then swaps in a
+ * snapshot of the result. The caller holds the mutex.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void ConcurrentGraph<vertex, edge, direction>::apply() {
+    GRAPH_LOG("Committing " << pending.size() << " updates");
+    std::vector<std::tuple<vertex, vertex, edge>> additions;
+    for (size_type i = 0; i < pending.size(); ++i) {
+        const update &u = pending[i];
+        if (u.kind == update_kind::add)
+            additions.emplace_back(u.node1, u.node2, u.weight);
+        if (!additions.empty() && (i + 1 == pending.size() || pending[i + 1].kind != update_kind::add)) {
+            network.add_edges(additions.begin(), additions.end());
+            additions.clear();
+        }
+        if (u.kind == update_kind::remove)
+            network.delete_edge(u.node1, u.node2);
+        else if (u.kind == update_kind::modify)
+            network.modify_edge(u.node1, u.node2, u.weight);
+    }
+    pending.clear();
+
+    // A reader that announced the new epoch loaded current after the exchange, so only readers
+    // pinned to an older epoch can still hold the old snapshot
+    const snapshot_type *old = current.exchange(new snapshot_type(network.freeze()));
+    uint64_t replaced = epoch.fetch_add(1) + 1;
+    retired.emplace_back(replaced, std::unique_ptr<const snapshot_type>(old));
+    reclaim();
+}
+
+/**
+ * Deletes the retired snapshots no reader can still be using. The caller holds the mutex.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void ConcurrentGraph<vertex, edge, direction>::reclaim() {
+    uint64_t oldest = UINT64_MAX;
+    for (size_type i = 0; i < slot_count; ++i) {
+        uint64_t e = slots[i].epoch.load();
+        if (e != 0 && e < oldest)
+            oldest = e;
+    }
+    size_type kept = 0;
+    for (size_type i = 0; i < retired.size(); ++i) {
+        if (oldest < retired[i].first)
+            retired[kept++] = std::move(retired[i]);
+    }
+    retired.resize(kept);
+}
+
+/**
+ * Returns the number of updates waiting for the next commit.
+ *
+ * @return The length of the update queue.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename ConcurrentGraph<vertex, edge, direction>::size_type ConcurrentGraph<vertex, edge, direction>::pending_updates() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+
+/**
+ * Returns the number of the current snapshot, which grows by one with every commit.
+ *
+ * @return The current epoch, 1 for the initial empty snapshot.
+ */
+template <typename vertex, typename edge, Direction direction>
+uint64_t ConcurrentGraph<vertex, edge, direction>::version() const {
+    return epoch.load();
+}
+
+/**
+ * Claims a reader slot of the graph.
+ *
+ * @param graph The graph to read, which must outlive the reader.
+ */
+template <typename vertex, typename edge, Direction direction>
+ConcurrentGraph<vertex, edge, direction>::reader::reader(ConcurrentGraph<vertex, edge, direction> &graph) : owner(graph), slot(0) {
+    for (; slot < owner.slot_count; ++slot) {
+        bool free = false;
+        if (owner.slots[slot].claimed.compare_exchange_strong(free, true))
+            return;
+    }
+    throw std::runtime_error("too many concurrent readers");
+}
+
+/**
+ * Gives the reader slot back.
+ */
+template <typename vertex, typename edge, Direction direction>
+ConcurrentGraph<vertex, edge, direction>::reader::~reader() {
+    owner.slots[slot].claimed.store(false, std::memory_order_release);
+}
+
+/**
+ * Runs a function on the current snapshot without taking locks. The snapshot stays valid until the
+ * function returns, even if writers publish newer ones meanwhile; references into it must not escape.
+ * fn may call read() on the same reader again: the nested call keeps the outer, older pin, which also
+ * protects every newer snapshot, and the outer pin is restored when it returns.
+ *
+ * @param fn Callable fn(const CsrGraph<vertex, edge> &).
+ *
+ * @return The result of fn.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename function>
+auto ConcurrentGraph<vertex, edge, direction>::reader::read(function fn) -> decltype(fn(std::declval<const snapshot_type &>())) {
+    struct unpin {
+        std::atomic<uint64_t> &epoch;
+        uint64_t previous;
+        ~unpin() { epoch.store(previous, std::memory_order_release); }
+    };
+
+    // Only the owning thread writes its slot, so a relaxed load sees its own outer pin
+    std::atomic<uint64_t> &pinned = owner.slots[slot].epoch;
+    uint64_t outer = pinned.load(std::memory_order_relaxed);
+    if (outer == 0)
+        pinned.store(owner.epoch.load());
+    unpin guard{pinned, outer};
+    return fn(*owner.current.load());
+}
+
+/**
+ * Finds the shortest path between two vertices in the current snapshot.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param bidirectional Search from both ends at once and stop when the two searches meet.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::pair<edge, std::vector<vertex>> ConcurrentGraph<vertex, edge, direction>::reader::shortest_path(const vertex &src, const vertex &dst,
+                                                                                                     bool bidirectional) {
+    return read([&](const snapshot_type &graph) { return graph.shortest_path(src, dst, bidirectional); });
+}
+
+/**
+ * Checks if a vertex is part of the current snapshot.
+ *
+ * @param node The vertex to look up.
+ *
+ * @return true if the vertex is in the snapshot, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool ConcurrentGraph<vertex, edge, direction>::reader::has_vertex(const vertex &node) {
+    return read([&](const snapshot_type &graph) { return graph.id(node) != snapshot_type::npos; });
+}
@@ -0,0 +1,1729 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flat_array.h"
+#include "graph.h"
+#include "graph_file.h"
+#include "indexed_heap.h"
+#include "interner.h"
+#include "thread_pool.h"
+#include "union_find.h"
+
+// Breadth first levels and parents indexed by the dense ids of a CsrGraph
+struct BreadthFirstTree {
+    // Number of edges on a shortest path from the source, CsrGraph::npos if unreachable
+    std::vector<uint32_t> level;
+
+    // Vertex the search reached this one from, the source for itself, CsrGraph::npos if unreachable
+    std::vector<uint32_t> parent;
+};
+
+// Minimum spanning forest of a CsrGraph as edges between dense ids, one tree per connected component
+template <typename edge>
+struct SpanningTree {
+    // (id, id, weight) of every tree edge
+    std::vector<std::tuple<uint32_t, uint32_t, edge>> edges;
+
+    // Sum of the weights of the tree edges
+    edge weight;
+};
+
+// Orders CsrGraph::reorder() can lay the vertices out in, so that vertices used together get nearby ids
+enum class VertexOrder {
+    // Breadth first from a vertex far from the centre of each component, neighbours by degree, then reversed;
+    // keeps the ids of neighbours close, which suits road networks and meshes
+    reverse_cuthill_mckee,
+
+    // Highest degree first, so the hubs of a social graph share a few cache lines
+    degree,
+
+    // Plain breadth first order, component by component
+    breadth_first
+};
+
+template <typename vertex = int, // CsrGraph::vertex_type
+          typename edge = double // CsrGraph::edge_type
+          >
+class CsrGraph {
+public:
+    typedef vertex vertex_type;
+    typedef edge edge_type;
+    typedef uint32_t id_type;
+    typedef size_t size_type;
+
+    // Returned by id() for vertices that are not part of the snapshot
+    static constexpr id_type npos = UINT32_MAX;
+
+private:
+    // Vertex <-> dense id
+    VertexInterner<vertex> names;
+
+    // Neighbours of id u are targets[offsets[u]] .. targets[offsets[u + 1] - 1], either owned or
+    // read in place from a mapped file
+    FlatArray<size_type> offsets;
+    FlatArray<id_type> targets;
+    FlatArray<edge> weights;
+
+    // Edges entering every vertex, laid out like the arrays above; empty for undirected snapshots,
+    // whose out-edges serve both directions
+    bool directed_edges;
+    FlatArray<size_type> in_offsets;
+    FlatArray<id_type> in_targets;
+    FlatArray<edge> in_weights;
+
+    void transpose();
+    static bool well_formed(const size_type *, const id_type *, size_type, size_type);
+    std::vector<std::tuple<id_type, id_type, edge>> edge_list() const;
+
+public:
+    CsrGraph();
+    template <typename adjacency>
+    explicit CsrGraph(const adjacency &, bool = false);
+    template <typename input_iterator>
+    CsrGraph(input_iterator, input_iterator, bool = false, bool = false);
+
+    void save(const std::string &) const;
+    static CsrGraph<vertex, edge> load(const std::string &, bool = true);
+
+    size_type size() const;
+    size_type edge_count() const;
+    bool empty() const;
+    bool directed() const;
+
+    id_type id(const vertex &) const;
+    const vertex &vertex_at(id_type) const;
+    size_type degree(id_type) const;
+    size_type edge_begin(id_type) const;
+    size_type edge_end(id_type) const;
+    id_type target(size_type) const;
+    const edge &weight(size_type) const;
+    size_type in_degree(id_type) const;
+    size_type in_edge_begin(id_type) const;
+    size_type in_edge_end(id_type) const;
+    id_type in_target(size_type) const;
+    const edge &in_weight(size_type) const;
+
+    std::vector<id_type> vertex_order(VertexOrder) const;
+    CsrGraph<vertex, edge> permute(const std::vector<id_type> &) const;
+    CsrGraph<vertex, edge> reorder(VertexOrder) const;
+
+    std::vector<vertex> bfs(const vertex &, bool = false) const;
+    std::vector<vertex> dfs(const vertex &) const;
+    BreadthFirstTree parallel_bfs(const vertex &, unsigned = 0) const;
+    std::vector<id_type> connected_components(unsigned = 0) const;
+    SpanningTree<edge> minimum_spanning_tree() const;
+    SpanningTree<edge> parallel_minimum_spanning_tree(unsigned = 0) const;
+    std::vector<double> page_rank(double = 0.85, double = 1e-6, size_type = 100, unsigned = 0) const;
+    std::vector<double> degree_centrality() const;
+    std::vector<double> betweenness_centrality(bool = false, unsigned = 0) const;
+    ShortestPathTree<edge> shortest_paths(const vertex &) const;
+    std::vector<ShortestPathTree<edge>> shortest_paths(const std::vector<vertex> &, unsigned = 0) const;
+    std::vector<std::vector<std::pair<vertex, edge>>> nearest(const std::vector<vertex> &, size_type, const edge & = std::numeric_limits<edge>::max(), unsigned = 0) const;
+    std::vector<std::vector<std::pair<vertex, edge>>> within(const std::vector<vertex> &, const edge &, unsigned = 0) const;
+    ShortestPathTree<edge> delta_stepping(const vertex &, edge = edge(), unsigned = 0) const;
+    std::map<vertex, std::pair<vertex, edge>> dijkstra(const vertex &) const;
+    std::pair<edge, std::vector<vertex>> shortest_path(const vertex &, const vertex &, bool = false) const;
+    template <typename heuristic>
+    std::pair<edge, std::vector<vertex>> astar(const vertex &, const vertex &, heuristic) const;
+};
+
+/**
+ * Constructs an empty snapshot.
+ */
+template <typename vertex, typename edge>
+CsrGraph<vertex, edge>::CsrGraph() : offsets(std::vector<size_type>(1, 0)), directed_edges(false) {}
+
+/**
+ * Builds a snapshot from an adjacency map, e.g. the network of a Graph.
+ * Neighbours keep the order in which the adjacency map lists them.
+ *
+ * @param network A map of every vertex to a range of (neighbour, weight) pairs.
+ * @param directed The map lists only the edges leaving every vertex, so the edges entering it are indexed too.
+ */
+template <typename vertex, typename edge>
+template <typename adjacency>
+CsrGraph<vertex, edge>::CsrGraph(const adjacency &network, bool directed) : directed_edges(directed) {
+    names.reserve(network.size());
+    size_type edges = 0;
+    for (const auto &x : network) {
+        names.intern(x.first);
+        edges += x.second.size();
+    }
+
+    std::vector<size_type> offset_list;
+    std::vector<id_type> target_list;
+    std::vector<edge> weight_list;
+    offset_list.reserve(names.size() + 1);
+    target_list.reserve(edges);
+    weight_list.reserve(edges);
+    offset_list.push_back(0);
+    for (const auto &x : network) {
+        for (const auto &y : x.second) {
+            target_list.push_back(names.id(y.first));
+            weight_list.push_back(y.second);
+        }
+        offset_list.push_back(target_list.size());
+    }
+    offsets = FlatArray<size_type>(std::move(offset_list));
+    targets = FlatArray<id_type>(std::move(target_list));
+    weights = FlatArray<edge>(std::move(weight_list));
+    if (directed_edges)
+        transpose();
+}
+
+/**
+ * Builds a snapshot straight from a list of edges, without going through a Graph.
+ * Vertices get ids in order of first appearance and neighbours are ordered by id. Every undirected edge is
+ * kept once per endpoint, every directed edge once in the out-edges of its first and once in the in-edges
+ * of its second vertex; repeated edges keep their first weight, or their smallest with keep_minimum.
+ *
+ * @param first Iterator to the first edge, a tuple-like (vertex1, vertex2, weight) read with std::get.
+ * @param last Iterator past the last edge.
+ * @param keep_minimum Keep the smallest weight of repeated edges instead of the first.
+ * @param directed Edges lead from vertex1 to vertex2.
+ */
+template <typename vertex, typename edge>
+template <typename input_iterator>
+CsrGraph<vertex, edge>::CsrGraph(input_iterator first, input_iterator last, bool keep_minimum, bool directed) : directed_edges(directed) {
+    std::vector<std::pair<id_type, id_type>> ends;
+    std::vector<edge> lengths;
+    for (; first != last; ++first) {
+        const auto &e = *first;
+        id_type u = names.intern(std::get<0>(e));
+        id_type v = names.intern(std::get<1>(e));
+        ends.emplace_back(u, v);
+        lengths.push_back(std::get<2>(e));
+    }
+
+    // Counting sort of both directions of every edge by source id
+    std::vector<size_type> degree(names.size() + 1, 0);
+    for (const std::pair<id_type, id_type> &x : ends) {
+        ++degree[x.first + 1];
+        if (!directed_edges && x.first != x.second)
+            ++degree[x.second + 1];
+    }
+    for (size_type u = 0; u < names.size(); ++u)
+        degree[u + 1] += degree[u];
+
+    std::vector<std::pair<id_type, edge>> arcs(degree.back());
+    std::vector<size_type> next(degree.begin(), degree.end() - 1);
+    for (size_type i = 0; i < ends.size(); ++i) {
+        id_type u = ends[i].first, v = ends[i].second;
+        arcs[next[u]++] = std::make_pair(v, lengths[i]);
+        if (!directed_edges && u != v)
+            arcs[next[v]++] = std::make_pair(u, lengths[i]);
+    }
+    std::vector<std::pair<id_type, id_type>>().swap(ends);
+    std::vector<edge>().swap(lengths);
+
+    // Order every neighbourhood by id and drop repeated edges; the scatter kept input order, so a
+    // stable sort leaves the first occurrence first
+    std::vector<size_type> offset_list;
+    std::vector<id_type> target_list;
+    std::vector<edge> weight_list;
+    offset_list.reserve(names.size() + 1);
+    target_list.reserve(arcs.size());
+    weight_list.reserve(arcs.size());
+    offset_list.push_back(0);
+    for (size_type u = 0; u < names.size(); ++u) {
+        std::stable_sort(arcs.begin() + degree[u], arcs.begin() + degree[u + 1],
+                         [](const std::pair<id_type, edge> &lhs, const std::pair<id_type, edge> &rhs) { return lhs.first < rhs.first; });
+        for (size_type e = degree[u]; e < degree[u + 1]; ++e) {
+            if (target_list.size() > offset_list.back() && target_list.back() == arcs[e].first) {
+                if (keep_minimum && arcs[e].second < weight_list.back())
+                    weight_list.back() = arcs[e].second;
+                continue;
+            }
+            target_list.push_back(arcs[e].first);
+            weight_list.push_back(arcs[e].second);
+        }
+        offset_list.push_back(target_list.size());
+    }
+    offsets = FlatArray<size_type>(std::move(offset_list));
+    targets = FlatArray<id_type>(std::move(target_list));
+    weights = FlatArray<edge>(std::move(weight_list));
+    if (directed_edges)
+        transpose();
+}
+
+/**
+ * Builds the in-edge arrays of a directed snapshot from its out-edges with a counting sort by target,
+ * so the in-edges of every vertex are ordered by source id.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void CsrGraph<vertex, edge>::transpose() {
+    std::vector<size_type> offset_list(names.size() + 1, 0);
+    for (id_type v : targets)
+        ++offset_list[v + 1];
+    for (size_type v = 0; v < names.size(); ++v)
+        offset_list[v + 1] += offset_list[v];
+
+    std::vector<id_type> source_list(targets.size());
+    std::vector<edge> weight_list(targets.size());
+    std::vector<size_type> next(offset_list.begin(), offset_list.end() - 1);
+    for (id_type u = 0; u < names.size(); ++u) {
+        for (size_type e = offsets[u]; e < offsets[u + 1]; ++e) {
+            size_type slot = next[targets[e]]++;
+            source_list[slot] = u;
+            weight_list[slot] = weights[e];
+        }
+    }
+    in_offsets = FlatArray<size_type>(std::move(offset_list));
+    in_targets = FlatArray<id_type>(std::move(source_list));
+    in_weights = FlatArray<edge>(std::move(weight_list));
+}
+
+/**
+ * Writes the snapshot to a binary file that load() maps back into memory without parsing it.
+ * The file holds a versioned header, the vertex table and the offset, target and weight arrays,
+ * followed by the in-edge arrays of directed snapshots.
+ * edge and vertex must be trivially copyable, except std::string vertices which are stored in a string table.
+ *
+ * @param path The file to write.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void CsrGraph<vertex, edge>::save(const std::string &path) const {
+    static_assert(std::is_trivially_copyable<edge>::value, "graph files store weights as raw bytes");
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot create " + path);
+
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "CSRGRAPH", sizeof(header.magic));
+    header.version = graph_file_version;
+    header.byte_order = 0x01020304;
+    header.vertex_size = GraphFileVertices<vertex>::vertex_size;
+    header.edge_size = sizeof(edge);
+    header.vertices = size();
+    header.entries = edge_count();
+    header.flags = directed_edges ? graph_file_directed : 0;
+
+    // Sections first, then the header with their offsets over the placeholder
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    header.vertex_table = graph_file_align(out);
+    GraphFileVertices<vertex>::write(out, names);
+    header.offset_table = graph_file_align(out);
+    out.write(reinterpret_cast<const char *>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(size_type)));
+    header.target_table = graph_file_align(out);
+    out.write(reinterpret_cast<const char *>(targets.data()), static_cast<std::streamsize>(targets.size() * sizeof(id_type)));
+    header.weight_table = graph_file_align(out);
+    out.write(reinterpret_cast<const char *>(weights.data()), static_cast<std::streamsize>(weights.size() * sizeof(edge)));
+    if (directed_edges) {
+        header.in_offset_table = graph_file_align(out);
+        out.write(reinterpret_cast<const char *>(in_offsets.data()), static_cast<std::streamsize>(in_offsets.size() * sizeof(size_type)));
+        header.in_target_table = graph_file_align(out);
+        out.write(reinterpret_cast<const char *>(in_targets.data()), static_cast<std::streamsize>(in_targets.size() * sizeof(id_type)));
+        header.in_weight_table = graph_file_align(out);
+        out.write(reinterpret_cast<const char *>(in_weights.data()), static_cast<std::streamsize>(in_weights.size() * sizeof(edge)));
+    }
+    header.file_size = static_cast<uint64_t>(out.tellp());
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!out)
+        throw std::runtime_error("cannot write " + path);
+}
+
+/**
+ * Maps a file written by save() into memory. The offset, target and weight arrays are read in place,
+ * so loading costs only the vertex table and pages are read from disk as queries touch them.
+ * Files of version 1, which predate directed snapshots, load as undirected snapshots.
+ * The file must not be modified while any copy of the snapshot is alive. Corrupt files throw
+ * std::runtime_error: the header and table bounds are always checked, and by default one pass over the
+ * offset and target arrays makes sure every edge stays within the snapshot, which reads them from disk.
+ *
+ * @param path The file to map.
+ * @param validate Check the offset and target arrays; only skip this for trusted files, as queries on a
+ *                 corrupt file then read out of bounds.
+ *
+ * @return A snapshot backed by the mapped file.
+ */
+template <typename vertex, typename edge>
+CsrGraph<vertex, edge> CsrGraph<vertex, edge>::load(const std::string &path, bool validate) {
+    static_assert(std::is_trivially_copyable<edge>::value, "graph files store weights as raw bytes");
+    static_assert(sizeof(size_type) == sizeof(uint64_t), "graph files store offsets as 64 bit integers");
+
+    std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(path);
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    if (file->size() < graph_file_v1_header)
+        throw std::runtime_error(path + " is not a graph file");
+    std::memcpy(&header, file->data(), graph_file_v1_header);
+    if (std::memcmp(header.magic, "CSRGRAPH", sizeof(header.magic)) != 0)
+        throw std::runtime_error(path + " is not a graph file");
+    if (header.version < 1 || header.version > graph_file_version || header.byte_order != 0x01020304)
+        throw std::runtime_error(path + " has an unsupported version or byte order");
+    size_t header_size = header.version == 1 ? graph_file_v1_header : sizeof(header);
+    if (file->size() < header_size)
+        throw std::runtime_error(path + " is truncated or corrupt");
+    std::memcpy(&header, file->data(), header_size);
+    if (header.vertex_size != GraphFileVertices<vertex>::vertex_size || header.edge_size != sizeof(edge))
+        throw std::runtime_error(path + " was saved with different vertex or edge types");
+    bool directed = header.flags & graph_file_directed;
+    // Every table must fit in the file; the bounds are checked by dividing the room left after the table,
+    // so counts from a corrupt header cannot wrap the byte sizes around
+    uint64_t size = file->size();
+    auto fits = [size](uint64_t table, uint64_t count, uint64_t width) { return table <= size && count <= (size - table) / width; };
+    uint64_t offset_bytes = (header.vertices + 1) * sizeof(size_type);
+    uint64_t target_bytes = header.entries * sizeof(id_type);
+    uint64_t weight_bytes = header.entries * sizeof(edge);
+    if (header.file_size != size || header.vertices >= size / sizeof(size_type) || header.vertex_table < header_size ||
+        header.offset_table < header.vertex_table || !fits(header.offset_table, header.vertices + 1, sizeof(size_type)) ||
+        header.target_table < header.offset_table + offset_bytes || !fits(header.target_table, header.entries, sizeof(id_type)) ||
+        header.weight_table < header.target_table + target_bytes || !fits(header.weight_table, header.entries, sizeof(edge)) ||
+        (directed && (header.in_offset_table < header.weight_table + weight_bytes ||
+                      !fits(header.in_offset_table, header.vertices + 1, sizeof(size_type)) ||
+                      header.in_target_table < header.in_offset_table + offset_bytes ||
+                      !fits(header.in_target_table, header.entries, sizeof(id_type)) ||
+                      header.in_weight_table < header.in_target_table + target_bytes ||
+                      !fits(header.in_weight_table, header.entries, sizeof(edge)))))
+        throw std::runtime_error(path + " is truncated or corrupt");
+
+    CsrGraph<vertex, edge> graph;
+    const char *data = file->data();
+    GraphFileVertices<vertex>::read(data + header.vertex_table, data + header.offset_table, header.vertices, graph.names);
+    if (graph.names.size() != header.vertices)
+        throw std::runtime_error(path + " lists a vertex twice");
+
+    const size_type *offset_data = reinterpret_cast<const size_type *>(data + header.offset_table);
+    if (offset_data[0] != 0 || offset_data[header.vertices] != header.entries)
+        throw std::runtime_error(path + " is truncated or corrupt");
+    const id_type *target_data = reinterpret_cast<const id_type *>(data + header.target_table);
+    if (validate && !well_formed(offset_data, target_data, header.vertices, header.entries))
+        throw std::runtime_error(path + " is truncated or corrupt");
+    graph.offsets = FlatArray<size_type>(offset_data, header.vertices + 1, file);
+    graph.targets = FlatArray<id_type>(target_data, header.entries, file);
+    graph.weights = FlatArray<edge>(reinterpret_cast<const edge *>(data + header.weight_table), header.entries, file);
+    graph.directed_edges = directed;
+    if (directed) {
+        const size_type *in_offset_data = reinterpret_cast<const size_type *>(data + header.in_offset_table);
+        const id_type *in_target_data = reinterpret_cast<const id_type *>(data + header.in_target_table);
+        if (in_offset_data[0] != 0 || in_offset_data[header.vertices] != header.entries ||
+            (validate && !well_formed(in_offset_data, in_target_data, header.vertices, header.entries)))
+            throw std::runtime_error(path + " is truncated or corrupt");
+        graph.in_offsets = FlatArray<size_type>(in_offset_data, header.vertices + 1, file);
+        graph.in_targets = FlatArray<id_type>(in_target_data, header.entries, file);
+        graph.in_weights = FlatArray<edge>(reinterpret_cast<const edge *>(data + header.in_weight_table), header.entries, file);
+    }
+    return graph;
+}
+
+/**
+ * Checks that offset and target arrays read from a file describe a valid adjacency: offsets start at 0,
+ * never decrease and end at the number of entries, and every target is a dense id.
+ *
+ * @param offset_data The vertices + 1 offsets.
+ * @param target_data The entries targets.
+ * @param vertices The number of vertices.
+ * @param entries The number of edge entries.
+ *
+ * @return true if the arrays are consistent, false otherwise.
+ */
+template <typename vertex, typename edge>
+bool CsrGraph<vertex, edge>::well_formed(const size_type *offset_data, const id_type *target_data, size_type vertices, size_type entries) {
+    if (offset_data[0] != 0 || offset_data[vertices] != entries)
+        return false;
+    for (size_type u = 0; u < vertices; ++u) {
+        if (offset_data[u + 1] < offset_data[u])
+            return false;
+    }
+    for (size_type e = 0; e < entries; ++e) {
+        if (target_data[e] >= vertices)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Returns the number of vertices in the snapshot.
+ *
+ * @return The number of vertices.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::size() const {
+    return names.size();
+}
+
+/**
+ * Returns the number of stored adjacency entries.
+ * Every undirected edge is stored once per endpoint, every directed edge once.
+ *
+ * @return The length of the target and weight arrays.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::edge_count() const {
+    return targets.size();
+}
+
+/**
+ * Checks if the snapshot keeps the edges leaving and entering every vertex apart.
+ *
+ * @return true for snapshots of directed graphs, false otherwise.
+ */
+template <typename vertex, typename edge>
+bool CsrGraph<vertex, edge>::directed() const {
+    return directed_edges;
+}
+
+/**
+ * Checks if the snapshot is empty.
+ *
+ * @return true if there are no vertices, false otherwise.
+ */
+template <typename vertex, typename edge>
+bool CsrGraph<vertex, edge>::empty() const {
+    return names.empty();
+}
+
+/**
+ * Looks up the dense id of a vertex.
+ *
+ * @param node The vertex to look up.
+ *
+ * @return The id of the vertex, or npos if the vertex is not in the snapshot.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::id_type CsrGraph<vertex, edge>::id(const vertex &node) const {
+    return names.id(node);
+}
+
+/**
+ * Returns the vertex with the given dense id.
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return The vertex interned under u.
+ */
+template <typename vertex, typename edge>
+const vertex &CsrGraph<vertex, edge>::vertex_at(id_type u) const {
+    return names.vertex_at(u);
+}
+
+/**
+ * Returns the number of neighbours of a vertex.
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return The degree of u.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::degree(id_type u) const {
+    return offsets[u + 1] - offsets[u];
+}
+
+/**
+ * Returns the index of the first adjacency entry of a vertex.
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return An index into the target and weight arrays.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::edge_begin(id_type u) const {
+    return offsets[u];
+}
+
+/**
+ * Returns the index one past the last adjacency entry of a vertex.
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return An index into the target and weight arrays.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::edge_end(id_type u) const {
+    return offsets[u + 1];
+}
+
+/**
+ * Returns the neighbour stored in an adjacency entry.
+ *
+ * @param e An index between edge_begin(u) and edge_end(u).
+ *
+ * @return The dense id of the neighbour.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::id_type CsrGraph<vertex, edge>::target(size_type e) const {
+    return targets[e];
+}
+
+/**
+ * Returns the weight stored in an adjacency entry.
+ *
+ * @param e An index between edge_begin(u) and edge_end(u).
+ *
+ * @return The weight of the edge.
+ */
+template <typename vertex, typename edge>
+const edge &CsrGraph<vertex, edge>::weight(size_type e) const {
+    return weights[e];
+}
+
+/**
+ * Returns the number of edges entering a vertex, the degree for undirected snapshots.
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return The in-degree of u.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::in_degree(id_type u) const {
+    return in_edge_end(u) - in_edge_begin(u);
+}
+
+/**
+ * Returns the index of the first entry of a vertex in the in-edge arrays.
+ * Undirected snapshots share one set of arrays, so this equals edge_begin(u).
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return An index for in_target and in_weight.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::in_edge_begin(id_type u) const {
+    return directed_edges ? in_offsets[u] : offsets[u];
+}
+
+/**
+ * Returns the index one past the last entry of a vertex in the in-edge arrays.
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return An index for in_target and in_weight.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::size_type CsrGraph<vertex, edge>::in_edge_end(id_type u) const {
+    return directed_edges ? in_offsets[u + 1] : offsets[u + 1];
+}
+
+/**
+ * Returns the vertex an entering edge comes from.
+ *
+ * @param e An index between in_edge_begin(u) and in_edge_end(u).
+ *
+ * @return The dense id of the predecessor.
+ */
+template <typename vertex, typename edge>
+typename CsrGraph<vertex, edge>::id_type CsrGraph<vertex, edge>::in_target(size_type e) const {
+    return directed_edges ? in_targets[e] : targets[e];
+}
+
+/**
+ * Returns the weight of an entering edge.
+ *
+ * @param e An index between in_edge_begin(u) and in_edge_end(u).
+ *
+ * @return The weight of the edge.
+ */
+template <typename vertex, typename edge>
+const edge &CsrGraph<vertex, edge>::in_weight(size_type e) const {
+    return directed_edges ? in_weights[e] : weights[e];
+}
+
+/**
+ * Computes a new layout of the vertices. Directed edges count in both directions.
+ *
+ * @param order The layout to compute.
+ *
+ * @return The dense ids in their new order, i.e. the old id of every new id, to be passed to permute().
+ */
+template <typename vertex, typename edge>
+std::vector<typename CsrGraph<vertex, edge>::id_type> CsrGraph<vertex, edge>::vertex_order(VertexOrder order) const {
+    // Pseudo-peripheral vertex search rounds per component, each one a breadth first search
+    const size_type rounds = 4;
+
+    size_type n = names.size();
+    std::vector<id_type> ids(n);
+    std::vector<size_type> links(n);
+    for (size_type u = 0; u < n; ++u) {
+        ids[u] = static_cast<id_type>(u);
+        links[u] = offsets[u + 1] - offsets[u] + (directed_edges ? in_offsets[u + 1] - in_offsets[u] : 0);
+    }
+    if (order == VertexOrder::degree) {
+        std::stable_sort(ids.begin(), ids.end(), [&](id_type a, id_type b) { return links[b] < links[a]; });
+        return ids;
+    }
+
+    auto neighbours = [&](id_type u, std::vector<id_type> &out) {
+        for (size_type e = offsets[u]; e < offsets[u + 1]; ++e)
+            out.push_back(targets[e]);
+        if (directed_edges) {
+            for (size_type e = in_offsets[u]; e < in_offsets[u + 1]; ++e)
+                out.push_back(in_targets[e]);
+        }
+    };
+
+    std::vector<id_type> result, adjacent;
+    result.reserve(n);
+    std::vector<uint32_t> level(n, npos);
+    std::vector<id_type> queue;
+
+    // Breadth first search that only measures levels, returning the vertex of least degree on the last level
+    auto farthest = [&](id_type root, size_type &depth) {
+        queue.assign(1, root);
+        level[root] = 0;
+        for (size_type head = 0; head < queue.size(); ++head) {
+            adjacent.clear();
+            neighbours(queue[head], adjacent);
+            for (id_type v : adjacent) {
+                if (level[v] == npos) {
+                    level[v] = level[queue[head]] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        depth = level[queue.back()];
+        id_type best = queue.back();
+        for (id_type u : queue) {
+            if (level[u] == depth && links[u] < links[best])
+                best = u;
+            level[u] = npos;
+        }
+        return best;
+    };
+
+    // Candidate roots, one per component is used; Cuthill-McKee starts from vertices of low degree
+    if (order == VertexOrder::reverse_cuthill_mckee)
+        std::stable_sort(ids.begin(), ids.end(), [&](id_type a, id_type b) { return links[a] < links[b]; });
+
+    std::vector<bool> placed(n, false);
+    for (id_type root : ids) {
+        if (placed[root])
+            continue;
+        if (order == VertexOrder::reverse_cuthill_mckee) {
+            size_type depth = 0, eccentricity = 0;
+            for (size_type r = 0; r < rounds; ++r) {
+                id_type far = farthest(root, eccentricity);
+                if (r > 0 && eccentricity <= depth)
+                    break;
+                depth = eccentricity;
+                root = far;
+            }
+        }
+
+        size_type head = result.size();
+        result.push_back(root);
+        placed[root] = true;
+        for (; head < result.size(); ++head) {
+            adjacent.clear();
+            neighbours(result[head], adjacent);
+            size_type first = result.size();
+            for (id_type v : adjacent) {
+                if (!placed[v]) {
+                    placed[v] = true;
+                    result.push_back(v);
+                }
+            }
+            if (order == VertexOrder::reverse_cuthill_mckee)
+                std::stable_sort(result.begin() + first, result.end(), [&](id_type a, id_type b) { return links[a] < links[b]; });
+        }
+    }
+    if (order == VertexOrder::reverse_cuthill_mckee)
+        std::reverse(result.begin(), result.end());
+    GRAPH_COUNT(vertices_visited, n);
+    return result;
+}
+
+/**
+ * Builds a copy of the snapshot with its dense ids relabelled. Vertices keep their values, so id() and
+ * vertex_at() map between them and the new ids; neighbours are ordered by new id.
+ *
+ * @param order Every dense id once, in the order the vertices should get the new ids 0 .. size() - 1.
+ *
+ * @return The relabelled snapshot.
+ */
+template <typename vertex, typename edge>
+CsrGraph<vertex, edge> CsrGraph<vertex, edge>::permute(const std::vector<id_type> &order) const {
+    size_type n = names.size();
+    std::vector<id_type> rank(n, npos);
+    if (order.size() != n)
+        throw std::invalid_argument("a vertex order must list every dense id once");
+    for (size_type i = 0; i < n; ++i) {
+        if (order[i] >= n || rank[order[i]] != npos)
+            throw std::invalid_argument("a vertex order must list every dense id once");
+        rank[order[i]] = static_cast<id_type>(i);
+    }
+
+    CsrGraph<vertex, edge> result;
+    result.directed_edges = directed_edges;
+    result.names.reserve(n);
+    for (id_type u : order)
+        result.names.intern(names.vertex_at(u));
+
+    std::vector<size_type> offset_list;
+    std::vector<id_type> target_list;
+    std::vector<edge> weight_list;
+    offset_list.reserve(n + 1);
+    target_list.reserve(targets.size());
+    weight_list.reserve(targets.size());
+    offset_list.push_back(0);
+    std::vector<std::pair<id_type, edge>> row;
+    for (id_type u : order) {
+        row.clear();
+        for (size_type e = offsets[u]; e < offsets[u + 1]; ++e)
+            row.emplace_back(rank[targets[e]], weights[e]);
+        std::sort(row.begin(), row.end(), [](const std::pair<id_type, edge> &lhs, const std::pair<id_type, edge> &rhs) { return lhs.first < rhs.first; });
+        for (const std::pair<id_type, edge> &x : row) {
+            target_list.push_back(x.first);
+            weight_list.push_back(x.second);
+        }
+        offset_list.push_back(target_list.size());
+    }
+    result.offsets = FlatArray<size_type>(std::move(offset_list));
+    result.targets = FlatArray<id_type>(std::move(target_list));
+    result.weights = FlatArray<edge>(std::move(weight_list));
+    if (directed_edges)
+        result.transpose();
+    return result;
+}
+
+/**
+ * Builds a copy of the snapshot with the vertices laid out in a cache friendly order, so traversals,
+ * shortest path searches and PageRank touch fewer cache lines per vertex. Snapshots taken with
+ * Graph::freeze() number the vertices in hash order, which scatters neighbours over the whole array.
+ *
+ * @param order The layout to use.
+ *
+ * @return The relabelled snapshot.
+ */
+template <typename vertex, typename edge>
+CsrGraph<vertex, edge> CsrGraph<vertex, edge>::reorder(VertexOrder order) const {
+    return permute(vertex_order(order));
+}
+
+/**
+ * Traverses the snapshot breadth first, in the same order as Graph::breadth_first_search_iterator.
+ *
+ * @param src The vertex to start from.
+ * @param reverse Follow the edges entering every vertex instead, finding the vertices that can reach src.
+ *
+ * @return The vertices in visiting order, or an empty vector if src is not in the snapshot.
+ */
+template <typename vertex, typename edge>
+std::vector<vertex> CsrGraph<vertex, edge>::bfs(const vertex &src, bool reverse) const {
+    std::vector<vertex> order;
+    id_type s = id(src);
+    if (s == npos)
+        return order;
+
+    const FlatArray<size_type> &first = reverse && directed_edges ? in_offsets : offsets;
+    const FlatArray<id_type> &next = reverse && directed_edges ? in_targets : targets;
+    std::vector<bool> visited(names.size(), false);
+    std::vector<id_type> q;
+    q.reserve(names.size());
+    q.push_back(s);
+    visited[s] = true;
+
+    for (size_type head = 0; head < q.size(); ++head) {
+        id_type u = q[head];
+        order.push_back(names.vertex_at(u));
+        for (size_type e = first[u]; e < first[u + 1]; ++e) {
+            id_type v = next[e];
+            if (!visited[v]) {
+                visited[v] = true;
+                q.push_back(v);
+            }
+        }
+    }
+    GRAPH_COUNT(vertices_visited, order.size());
+    return order;
+}
+
+/**
+ * Traverses the snapshot depth first, in the same order as Graph::depth_first_search_iterator.
+ *
+ * @param src The vertex to start from.
+ *
+ * @return The vertices in visiting order, or an empty vector if src is not in the snapshot.
+ */
+template <typename vertex, typename edge>
+std::vector<vertex> CsrGraph<vertex, edge>::dfs(const vertex &src) const {
+    std::vector<vertex> order;
+    id_type s = id(src);
+    if (s == npos)
+        return order;
+
+    std::vector<bool> visited(names.size(), false);
+    std::vector<id_type> st;
+    st.push_back(s);
+
+    while (!st.empty()) {
+        id_type u = st.back();
+        st.pop_back();
+        if (visited[u])
+            continue;
+        visited[u] = true;
+        order.push_back(names.vertex_at(u));
+        for (size_type e = offsets[u]; e < offsets[u + 1]; ++e) {
+            if (!visited[targets[e]])
+                st.push_back(targets[e]);
+        }
+    }
+    GRAPH_COUNT(vertices_visited, order.size());
+    return order;
+}
+
+/**
+ * Traverses the snapshot breadth first, one level at a time on a thread pool. Each level either pushes
+ * the frontier queue to unvisited neighbours (top-down) or lets every unvisited vertex look for a parent in
+ * the frontier bitmap (bottom-up), switching to bottom-up once the frontier touches a large share of the
+ * remaining edges and back when it shrinks again. Bottom-up levels of directed snapshots scan the edges
+ * entering every vertex.
+ *
+ * @param src The vertex to start from.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return Dense level and parent arrays, or arrays of npos if src is not in the snapshot.
+ */
+template <typename vertex, typename edge>
+BreadthFirstTree CsrGraph<vertex, edge>::parallel_bfs(const vertex &src, unsigned threads) const {
+    // Switching thresholds from Beamer et al., "Direction-Optimizing Breadth-First Search"
+    const size_type alpha = 14, beta = 24;
+
+    size_type n = names.size();
+    BreadthFirstTree tree;
+    tree.level.assign(n, npos);
+    tree.parent.assign(n, npos);
+    id_type s = id(src);
+    if (s == npos)
+        return tree;
+
+    const FlatArray<size_type> &in_first = directed_edges ? in_offsets : offsets;
+    const FlatArray<id_type> &in_next = directed_edges ? in_targets : targets;
+    ThreadPool pool(threads);
+    std::vector<std::atomic<id_type>> parent(n);
+    for (size_type u = 0; u < n; ++u)
+        parent[u].store(npos, std::memory_order_relaxed);
+    parent[s].store(s, std::memory_order_relaxed);
+    tree.level[s] = 0;
+
+    std::vector<id_type> queue(1, s);
+    std::vector<std::vector<id_type>> next(pool.size());
+    std::vector<uint64_t> frontier((n + 63) / 64, 0), discovered((n + 63) / 64, 0);
+    std::vector<size_type> found(pool.size()), found_edges(pool.size());
+
+    size_type frontier_size = 1, frontier_edges = degree(s);
+    size_type unexplored_edges = targets.size() - frontier_edges;
+    bool bottom_up = false;
+
+    for (id_type depth = 0; frontier_size > 0; ++depth) {
+        GRAPH_COUNT(vertices_visited, frontier_size);
+        if (!bottom_up && frontier_edges > unexplored_edges / alpha) {
+            std::fill(frontier.begin(), frontier.end(), 0);
+            for (id_type u : queue)
+                frontier[u >> 6] |= uint64_t(1) << (u & 63);
+            bottom_up = true;
+        } else if (bottom_up && frontier_size < n / beta) {
+            queue.clear();
+            for (size_type w = 0; w < frontier.size(); ++w) {
+                for (uint64_t bits = frontier[w]; bits; bits &= bits - 1)
+                    queue.push_back(static_cast<id_type>(w * 64 + __builtin_ctzll(bits)));
+            }
+            bottom_up = false;
+        }
+        std::fill(found.begin(), found.end(), 0);
+        std::fill(found_edges.begin(), found_edges.end(), 0);
+
+        if (bottom_up) {
+            // Every task owns 64 consecutive vertices, i.e. one bitmap word, so writes never collide
+            pool.parallel_for(0, frontier.size(), [&](size_t w, unsigned t) {
+                uint64_t bits = 0;
+                size_type last = std::min(n, (w + 1) * 64);
+                for (size_type v = w * 64; v < last; ++v) {
+                    if (parent[v].load(std::memory_order_relaxed) != npos)
+                        continue;
+                    for (size_type e = in_first[v]; e < in_first[v + 1]; ++e) {
+                        id_type u = in_next[e];
+                        if (frontier[u >> 6] >> (u & 63) & 1) {
+                            parent[v].store(u, std::memory_order_relaxed);
+                            tree.level[v] = depth + 1;
+                            bits |= uint64_t(1) << (v & 63);
+                            ++found[t];
+                            found_edges[t] += offsets[v + 1] - offsets[v];
+                            break;
+                        }
+                    }
+                }
+                discovered[w] = bits;
+            }, 16);
+            frontier.swap(discovered);
+        } else {
+            pool.parallel_for(0, queue.size(), [&](size_t i, unsigned t) {
+                id_type u = queue[i];
+                for (size_type e = offsets[u]; e < offsets[u + 1]; ++e) {
+                    id_type v = targets[e];
+                    id_type unset = npos;
+                    if (parent[v].load(std::memory_order_relaxed) == npos &&
+                        parent[v].compare_exchange_strong(unset, u, std::memory_order_relaxed)) {
+                        tree.level[v] = depth + 1;
+                        next[t].push_back(v);
+                        ++found[t];
+                        found_edges[t] += offsets[v + 1] - offsets[v];
+                    }
+                }
+            }, 64);
+            queue.clear();
+            for (std::vector<id_type> &list : next) {
+                queue.insert(queue.end(), list.begin(), list.end());
+                list.clear();
+            }
+        }
+
+        frontier_size = frontier_edges = 0;
+        for (size_type t = 0; t < found.size(); ++t) {
+            frontier_size += found[t];
+            frontier_edges += found_edges[t];
+        }
+        unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+    }
+
+    for (size_type u = 0; u < n; ++u)
+        tree.parent[u] = parent[u].load(std::memory_order_relaxed);
+    return tree;
+}
+
+/**
+ * Labels the connected components of the snapshot in parallel with Afforest (Sutton et al., "Optimizing
+ * Parallel Graph Connectivity Computation via Subgraph Sampling"). Every vertex first links to a couple of
+ * its neighbours, which already joins most of the largest component; a sample then finds that component,
+ * and only vertices outside it link to their remaining neighbours. Components of directed snapshots are
+ * weakly connected, i.e. edges count in both directions.
+ *
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return The component of every dense id, labelled with the smallest id in it.
+ */
+template <typename vertex, typename edge>
+std::vector<typename CsrGraph<vertex, edge>::id_type> CsrGraph<vertex, edge>::connected_components(unsigned threads) const {
+    const size_type rounds = 2, samples = 1024;
+
+    size_type n = names.size();
+    ThreadPool pool(threads);
+    std::vector<std::atomic<id_type>> comp(n);
+    for (size_type u = 0; u < n; ++u)
+        comp[u].store(static_cast<id_type>(u), std::memory_order_relaxed);
+
+    // Hooks the larger of the two roots below the smaller one, retrying when another thread got there first
+    auto link = [&](id_type u, id_type v) {
+        id_type p1 = comp[u].load(std::memory_order_relaxed), p2 = comp[v].load(std::memory_order_relaxed);
+        while (p1 != p2) {
+            id_type high = std::max(p1, p2), low = std::min(p1, p2);
+            id_type p_high = comp[high].load(std::memory_order_relaxed);
+            if (p_high == low)
+                break;
+            if (p_high == high && comp[high].compare_exchange_strong(p_high, low, std::memory_order_relaxed))
+                break;
+            p1 = comp[comp[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+            p2 = comp[low].load(std::memory_order_relaxed);
+        }
+    };
+    auto compress = [&] {
+        pool.parallel_for(0, n, [&](size_t u, unsigned) {
+            id_type c = comp[u].load(std::memory_order_relaxed);
+            while (c != comp[c].load(std::memory_order_relaxed)) {
+                c = comp[c].load(std::memory_order_relaxed);
+                comp[u].store(c, std::memory_order_relaxed);
+            }
+        }, 1024);
+    };
+
+    for (size_type r = 0; r < rounds; ++r) {
+        pool.parallel_for(0, n, [&](size_t u, unsigned) {
+            if (offsets[u] + r < offsets[u + 1])
+                link(static_cast<id_type>(u), targets[offsets[u] + r]);
+        }, 1024);
+        compress();
+    }
+
+    // The most frequent label in a sample is almost surely the largest component
+    id_type largest = 0;
+    if (n > 0) {
+        std::mt19937 gen(42);
+        std::map<id_type, size_type> counts;
+        for (size_type i = 0; i < samples; ++i)
+            ++counts[comp[gen() % n].load(std::memory_order_relaxed)];
+        size_type most = 0;
+        for (const std::pair<const id_type, size_type> &x : counts) {
+            if (x.second > most) {
+                most = x.second;
+                largest = x.first;
+            }
+        }
+    }
+
+    // Edges between the largest component and the rest are still seen from the other end
+    pool.parallel_for(0, n, [&](size_t u, unsigned) {
+        if (comp[u].load(std::memory_order_relaxed) == largest)
+            return;
+        for (size_type e = offsets[u] + rounds; e < offsets[u + 1]; ++e)
+            link(static_cast<id_type>(u), targets[e]);
+        if (directed_edges) {
+            for (size_type e = in_offsets[u]; e < in_offsets[u + 1]; ++e)
+                link(static_cast<id_type>(u), in_targets[e]);
+        }
+    }, 256);
+    compress();
+    GRAPH_COUNT(vertices_visited, n);
+
+    std::vector<id_type> label(n);
+    for (size_type u = 0; u < n; ++u)
+        label[u] = comp[u].load(std::memory_order_relaxed);
+    return label;
+}
+
+/**
+ * Lists every edge once as (smaller id, larger id, weight), leaving out self-loops. Both directions of
+ * a directed edge pair are listed.
+ *
+ * @return The flat edge array.
+ */
+template <typename vertex, typename edge>
+std::vector<std::tuple<typename CsrGraph<vertex, edge>::id_type, typename CsrGraph<vertex, edge>::id_type, edge>> CsrGraph<vertex, edge>::edge_list() const {
+    std::vector<std::tuple<id_type, id_type, edge>> list;
+    list.reserve(directed_edges ? targets.size() : targets.size() / 2);
+    for (id_type u = 0; u < names.size(); ++u) {
+        for (size_type e = offsets[u]; e < offsets[u + 1]; ++e) {
+            id_type v = targets[e];
+            if (u < v)
+                list.emplace_back(u, v, weights[e]);
+            else if (directed_edges && v < u)
+                list.emplace_back(v, u, weights[e]);
+        }
+    }
+    return list;
+}
+
+/**
+ * Finds a minimum spanning forest with Kruskal's algorithm: the flat edge array is sorted by weight and
+ * every edge joining two trees of a union-find is kept. Edges of directed snapshots count in both directions.
+ *
+ * @return The tree edges in order of weight and their total weight.
+ */
+template <typename vertex, typename edge>
+SpanningTree<edge> CsrGraph<vertex, edge>::minimum_spanning_tree() const {
+    std::vector<std::tuple<id_type, id_type, edge>> list = edge_list();
+    std::sort(list.begin(), list.end(), [](const std::tuple<id_type, id_type, edge> &lhs, const std::tuple<id_type, id_type, edge> &rhs) {
+        if (std::get<2>(lhs) < std::get<2>(rhs) || std::get<2>(rhs) < std::get<2>(lhs))
+            return std::get<2>(lhs) < std::get<2>(rhs);
+        return std::make_pair(std::get<0>(lhs), std::get<1>(lhs)) < std::make_pair(std::get<0>(rhs), std::get<1>(rhs));
+    });
+
+    SpanningTree<edge> tree;
+    tree.weight = edge();
+    UnionFind forest(names.size());
+    for (size_type i = 0; i < list.size() && tree.edges.size() + 1 < names.size(); ++i) {
+        if (forest.unite(std::get<0>(list[i]), std::get<1>(list[i]))) {
+            tree.edges.push_back(list[i]);
+            tree.weight = tree.weight + std::get<2>(list[i]);
+        }
+    }
+    GRAPH_COUNT(relaxations, list.size());
+    return tree;
+}
+
+/**
+ * Finds a minimum spanning forest with Borůvka's algorithm on a thread pool. Every round, each tree picks
+ * its lightest outgoing edge in parallel, the picked edges join the trees, and edges inside a tree are
+ * dropped, so the number of trees at least halves per round. Ties are broken by the ends and position
+ * of an edge, which keeps the picked edges free of cycles and gives the same total weight as Kruskal.
+ *
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return The tree edges, in no particular order, and their total weight.
+ */
+template <typename vertex, typename edge>
+SpanningTree<edge> CsrGraph<vertex, edge>::parallel_minimum_spanning_tree(unsigned threads) const {
+    const size_type none = SIZE_MAX;
+
+    size_type n = names.size();
+    std::vector<std::tuple<id_type, id_type, edge>> list = edge_list();
+    ThreadPool pool(threads);
+
+    // Tree of every vertex, named after its union-find root; root_of maps the names of the last round to the current ones
+    std::vector<id_type> comp(n), root_of(n);
+    for (size_type u = 0; u < n; ++u)
+        comp[u] = root_of[u] = static_cast<id_type>(u);
+    std::vector<std::atomic<size_type>> best(n);
+    for (size_type u = 0; u < n; ++u)
+        best[u].store(none, std::memory_order_relaxed);
+
+    auto lighter = [&](size_type a, size_type b) {
+        const std::tuple<id_type, id_type, edge> &x = list[a], &y = list[b];
+        if (std::get<2>(x) < std::get<2>(y) || std::get<2>(y) < std::get<2>(x))
+            return std::get<2>(x) < std::get<2>(y);
+        return std::make_tuple(std::get<0>(x), std::get<1>(x), a) < std::make_tuple(std::get<0>(y), std::get<1>(y), b);
+    };
+    auto offer = [&](id_type c, size_type e) {
+        size_type current = best[c].load(std::memory_order_relaxed);
+        while (current == none || lighter(e, current)) {
+            if (best[c].compare_exchange_weak(current, e, std::memory_order_relaxed))
+                break;
+        }
+    };
+
+    SpanningTree<edge> tree;
+    tree.weight = edge();
+    UnionFind forest(n);
+    std::vector<size_type> live(list.size());
+    for (size_type e = 0; e < list.size(); ++e)
+        live[e] = e;
+    std::vector<std::vector<size_type>> kept(pool.size());
+    std::vector<id_type> roots;
+
+    while (!live.empty()) {
+        // Drop edges inside a tree and offer the others to the trees at both ends
+        pool.parallel_for(0, live.size(), [&](size_t i, unsigned t) {
+            size_type e = live[i];
+            id_type cu = comp[std::get<0>(list[e])], cv = comp[std::get<1>(list[e])];
+            if (cu == cv)
+                return;
+            kept[t].push_back(e);
+            offer(cu, e);
+            offer(cv, e);
+        }, 1024);
+        GRAPH_COUNT(relaxations, live.size());
+        live.clear();
+        for (std::vector<size_type> &found : kept) {
+            live.insert(live.end(), found.begin(), found.end());
+            found.clear();
+        }
+        if (live.empty())
+            break;
+
+        // Every tree that merges has an outgoing edge, so it picked one and is listed here
+        roots.clear();
+        for (size_type u = 0; u < n; ++u) {
+            if (comp[u] == u && best[u].load(std::memory_order_relaxed) != none)
+                roots.push_back(static_cast<id_type>(u));
+        }
+        for (id_type c : roots) {
+            size_type e = best[c].load(std::memory_order_relaxed);
+            best[c].store(none, std::memory_order_relaxed);
+            if (forest.unite(std::get<0>(list[e]), std::get<1>(list[e]))) {
+                tree.edges.push_back(list[e]);
+                tree.weight = tree.weight + std::get<2>(list[e]);
+            }
+        }
+        for (id_type c : roots)
+            root_of[c] = forest.find(c);
+        pool.parallel_for(0, n, [&](size_t u, unsigned) { comp[u] = root_of[comp[u]]; }, 1024);
+    }
+    return tree;
+}
+
+/**
+ * Ranks the vertices with PageRank, every vertex pulling its new rank from its in-neighbours so that each
+ * rank is written by one thread only. A round first divides every rank by the out-degree of its vertex in
+ * one flat loop over dense arrays, so the sums that follow only gather from a contiguous array; the rank
+ * of vertices without out-edges is spread over all vertices. Vertices are split into fixed blocks that
+ * report their own change and dangling rank, so the result does not depend on the number of threads.
+ * Edge weights are ignored.
+ *
+ * @param damping The probability of following an edge rather than jumping to a random vertex.
+ * @param tolerance Stop once the ranks change by less than this in total (L1 norm) within a round.
+ * @param max_iterations Stop after this many rounds even if the ranks have not converged.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return The rank of every dense id, summing up to 1.
+ */
+template <typename vertex, typename edge>
+std::vector<double> CsrGraph<vertex, edge>::page_rank(double damping, double tolerance, size_type max_iterations, unsigned threads) const {
+    const size_type block = 4096;
+
+    size_type n = names.size();
+    if (n == 0)
+        return std::vector<double>();
+    size_type blocks = (n + block - 1) / block;
+    ThreadPool pool(threads);
+
+    // Undirected snapshots list every edge in both directions, so their out-edges are the in-edges
+    const size_type *from_offsets = directed_edges ? in_offsets.data() : offsets.data();
+    const id_type *from = directed_edges ? in_targets.data() : targets.data();
+
+    std::vector<double> rank(n, 1.0 / n), next(n), share(n), inverse_degree(n);
+    for (size_type u = 0; u < n; ++u)
+        inverse_degree[u] = offsets[u] == offsets[u + 1] ? 0.0 : 1.0 / (offsets[u + 1] - offsets[u]);
+    std::vector<double> dangling(blocks), change(blocks);
+
+    for (size_type round = 0; round < max_iterations; ++round) {
+        pool.parallel_for(0, blocks, [&](size_t b, unsigned) {
+            size_type first = b * block, last = std::min(n, first + block);
+            double lost = 0;
+            for (size_type u = first; u < last; ++u) {
+                share[u] = rank[u] * inverse_degree[u];
+                lost += inverse_degree[u] == 0.0 ? rank[u] : 0.0;
+            }
+            dangling[b] = lost;
+        });
+        double jump = 0;
+        for (double lost : dangling)
+            jump += lost;
+        jump = (1 - damping) / n + damping * jump / n;
+
+        pool.parallel_for(0, blocks, [&](size_t b, unsigned) {
+            size_type first = b * block, last = std::min(n, first + block);
+            double delta = 0;
+            for (size_type v = first; v < last; ++v) {
+                double sum = 0;
+                for (size_type e = from_offsets[v]; e < from_offsets[v + 1]; ++e)
+                    sum += share[from[e]];
+                next[v] = jump + damping * sum;
+                delta += std::fabs(next[v] - rank[v]);
+            }
+            change[b] = delta;
+        });
+        rank.swap(next);
+        GRAPH_COUNT(relaxations, from_offsets[n]);
+
+        double total = 0;
+        for (double delta : change)
+            total += delta;
+        if (total < tolerance)
+            break;
+    }
+    return rank;
+}
+
+/**
+ * Computes the degree centrality of every vertex, its number of neighbours as a fraction of all other
+ * vertices. Vertices of directed snapshots count both their in- and out-edges.
+ *
+ * @return The centrality of every dense id.
+ */
+template <typename vertex, typename edge>
+std::vector<double> CsrGraph<vertex, edge>::degree_centrality() const {
+    size_type n = names.size();
+    double scale = n > 1 ? 1.0 / (n - 1) : 1.0;
+    std::vector<double> centrality(n);
+    for (size_type u = 0; u < n; ++u) {
+        size_type d = offsets[u + 1] - offsets[u];
+        if (directed_edges)
+            d += in_offsets[u + 1] - in_offsets[u];
+        centrality[u] = d * scale;
+    }
+    return centrality;
+}
+
+/**
+ * Computes the betweenness centrality of every vertex with Brandes' algorithm ("A Faster Algorithm for
+ * Betweenness Centrality"): one search per source counts the shortest paths to every vertex, then the
+ * vertices are visited in reverse order of distance to add up how much of those paths pass through each.
+ * Sources are spread over a thread pool and every thread adds into its own score array, which are summed
+ * at the end. Weighted searches need positive weights.
+ *
+ * @param weighted Measure paths by the sum of their edge weights with Dijkstra's algorithm instead of
+ *                 by their number of edges with a breadth first search.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return The number of shortest paths between other vertices passing through every dense id, split
+ *         evenly between equally short paths; every pair of an undirected snapshot counts once.
+ */
+template <typename vertex, typename edge>
+std::vector<double> CsrGraph<vertex, edge>::betweenness_centrality(bool weighted, unsigned threads) const {
+    // Buffers of one thread, reset after every source to the state of no search
+    struct scratch {
+        std::vector<edge> distance;
+        std::vector<double> paths;
+        std::vector<double> dependency;
+        std::vector<double> score;
+        std::vector<id_type> order;
+        IndexedHeap<edge> heap;
+    };
+
+    size_type n = names.size();
+    ThreadPool pool(std::min<size_t>(threads == 0 ? std::thread::hardware_concurrency() : threads, std::max<size_t>(n, 1)));
+    std::vector<scratch> state(pool.size());
+
+    pool.parallel_for(0, n, [&](size_t s, unsigned t) {
+        scratch &x = state[t];
+        if (x.score.empty()) {
+            x.distance.assign(n, edge(INF));
+            x.paths.assign(n, 0.0);
+            x.dependency.assign(n, 0.0);
+            x.score.assign(n, 0.0);
+            if (weighted)
+                x.heap.resize(n);
+        }
+        auto length = [&](size_type e) { return weighted ? weights[e] : edge(1); };
+
+        // Counts the shortest paths through u to v, lists every vertex once its distance is final
+        auto relax = [&](id_type u, size_type e) {
+            id_type v = targets[e];
+            edge d = x.distance[u] + length(e);
+            if (d < x.distance[v]) {
+                bool found = x.distance[v] < edge(INF);
+                x.distance[v] = d;
+                x.paths[v] = x.paths[u];
+                if (weighted)
+                    x.heap.push_or_decrease(v, d);
+                else if (!found)
+                    x.order.push_back(v);
+            } else if (!(x.distance[v] < d)) {
+                x.paths[v] += x.paths[u];
+            }
+        };
+
+        x.order.clear();
+        x.distance[s] = edge();
+        x.paths[s] = 1.0;
+        if (weighted) {
+            x.heap.push(static_cast<id_type>(s), edge());
+            while (!x.heap.empty()) {
+                id_type u = x.heap.top();
+                x.heap.pop();
+                x.order.push_back(u);
+                for (size_type e = offsets[u]; e < offsets[u + 1]; ++e)
+                    relax(u, e);
+            }
+        } else {
+            x.order.push_back(static_cast<id_type>(s));
+            for (size_type head = 0; head < x.order.size(); ++head) {
+                for (size_type e = offsets[x.order[head]]; e < offsets[x.order[head] + 1]; ++e)
+                    relax(x.order[head], e);
+            }
+        }
+
+        // The successors of u on shortest paths are the neighbours exactly one edge further away
+        for (size_type i = x.order.size(); i-- > 0;) {
+            id_type u = x.order[i];
+            double sum = 0;
+            for (size_type e = offsets[u]; e < offsets[u + 1]; ++e) {
+                id_type v = targets[e];
+                edge d = x.distance[u] + length(e);
+                if (!(d < x.distance[v]) && !(x.distance[v] < d))
+                    sum += x.paths[u] / x.paths[v] * (1.0 + x.dependency[v]);
+            }
+            x.dependency[u] = sum;
+            if (u != s)
+                x.score[u] += sum;
+        }
+        GRAPH_COUNT(vertices_visited, x.order.size());
+
+        for (id_type u : x.order) {
+            x.distance[u] = edge(INF);
+            x.paths[u] = 0.0;
+            x.dependency[u] = 0.0;
+        }
+    });
+
+    // Undirected snapshots find every path once from either end
+    double scale = directed_edges ? 1.0 : 0.5;
+    std::vector<double> centrality(n, 0.0);
+    for (const scratch &x : state) {
+        for (size_type u = 0; u < x.score.size(); ++u)
+            centrality[u] += x.score[u];
+    }
+    for (double &c : centrality)
+        c *= scale;
+    return centrality;
+}
+
+/**
+ * Finds the shortest path from the given source vertex to all other vertices using Dijkstra's algorithm.
+ *
+ * @param src The source vertex from which to find the shortest path.
+ *
+ * @return Flat distance and predecessor arrays indexed by dense id.
+ */
+template <typename vertex, typename edge>
+ShortestPathTree<edge> CsrGraph<vertex, edge>::shortest_paths(const vertex &src) const {
+    ShortestPathEngine<vertex, edge> engine(*this);
+    engine.run(id(src));
+    return engine.release();
+}
+
+/**
+ * Finds the shortest paths from many source vertices at once, running one Dijkstra search per source
+ * on a thread pool. Every thread keeps its own engine and scratch buffers and reads the snapshot without locks.
+ *
+ * @param sources The source vertices.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return One flat shortest path tree per source, in the order of sources.
+ */
+template <typename vertex, typename edge>
+std::vector<ShortestPathTree<edge>> CsrGraph<vertex, edge>::shortest_paths(const std::vector<vertex> &sources, unsigned threads) const {
+    std::vector<ShortestPathTree<edge>> trees(sources.size());
+    ThreadPool pool(std::min<size_t>(threads == 0 ? std::thread::hardware_concurrency() : threads, std::max<size_t>(sources.size(), 1)));
+    std::vector<std::unique_ptr<ShortestPathEngine<vertex, edge>>> engines(pool.size());
+
+    pool.parallel_for(0, sources.size(), [&](size_t i, unsigned t) {
+        if (!engines[t])
+            engines[t].reset(new ShortestPathEngine<vertex, edge>(*this));
+        engines[t]->run(id(sources[i]));
+        trees[i] = engines[t]->result();
+    });
+    return trees;
+}
+
+/**
+ * Finds the k vertices closest to each of many sources within a distance, the source included. Every
+ * search stops once its k-th vertex is settled or the next one lies further away than max_distance.
+ * The searches run on a thread pool, every thread reusing the buffers of its own engine across the
+ * sources it handles.
+ *
+ * @param sources The source vertices.
+ * @param k The largest number of vertices to report per source.
+ * @param max_distance The largest distance to report vertices at.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return The (vertex, distance) pairs of every source in order of distance, in the order of sources.
+ */
+template <typename vertex, typename edge>
+std::vector<std::vector<std::pair<vertex, edge>>> CsrGraph<vertex, edge>::nearest(const std::vector<vertex> &sources, size_type k, const edge &max_distance,
+                                                                                  unsigned threads) const {
+    std::vector<std::vector<std::pair<vertex, edge>>> found(sources.size());
+    ThreadPool pool(std::min<size_t>(threads == 0 ? std::thread::hardware_concurrency() : threads, std::max<size_t>(sources.size(), 1)));
+    std::vector<std::unique_ptr<ShortestPathEngine<vertex, edge>>> engines(pool.size());
+
+    pool.parallel_for(0, sources.size(), [&](size_t i, unsigned t) {
+        if (!engines[t])
+            engines[t].reset(new ShortestPathEngine<vertex, edge>(*this));
+        const std::vector<std::pair<id_type, edge>> &nearby = engines[t]->run_nearest(id(sources[i]), k, max_distance);
+        found[i].reserve(nearby.size());
+        for (const std::pair<id_type, edge> &x : nearby)
+            found[i].emplace_back(names.vertex_at(x.first), x.second);
+    });
+    return found;
+}
+
+/**
+ * Finds the vertices within a distance of each of many sources, the source included, in parallel.
+ *
+ * @param sources The source vertices.
+ * @param max_distance The largest distance to report vertices at.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return The (vertex, distance) pairs of every source in order of distance, in the order of sources.
+ */
+template <typename vertex, typename edge>
+std::vector<std::vector<std::pair<vertex, edge>>> CsrGraph<vertex, edge>::within(const std::vector<vertex> &sources, const edge &max_distance, unsigned threads) const {
+    return nearest(sources, SIZE_MAX, max_distance, threads);
+}
+
+/**
+ * Finds the shortest path from the given source vertex to all other vertices with parallel delta-stepping.
+ * Tentative distances are grouped into buckets of width delta; the vertices of the lowest bucket relax
+ * their light edges (weight <= delta) in parallel until the bucket stays empty, then their heavy edges once.
+ * Gives the same distances as dijkstra for non-negative weights; edge must support +, / and conversion to size_t.
+ *
+ * @param src The source vertex.
+ * @param delta The bucket width, edge() for the average edge weight.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return Flat distance and predecessor arrays indexed by dense id.
+ */
+template <typename vertex, typename edge>
+ShortestPathTree<edge> CsrGraph<vertex, edge>::delta_stepping(const vertex &src, edge delta, unsigned threads) const {
+    size_type n = names.size();
+    ShortestPathTree<edge> tree;
+    tree.distance.assign(n, INF);
+    tree.parent.assign(n, npos);
+    id_type s = id(src);
+    if (s == npos)
+        return tree;
+
+    if (!(edge() < delta)) {
+        edge total = edge();
+        for (const edge &w : weights)
+            total = total + w;
+        delta = weights.empty() ? edge() : total / static_cast<edge>(weights.size());
+        if (!(edge() < delta))
+            delta = 1;
+    }
+
+    ThreadPool pool(threads);
+    std::vector<std::atomic<edge>> dist(n);
+    for (size_type u = 0; u < n; ++u)
+        dist[u].store(INF, std::memory_order_relaxed);
+    dist[s].store(edge(), std::memory_order_relaxed);
+
+    // Vertices whose distance dropped in the current round, one list per thread
+    std::vector<std::vector<id_type>> improved(pool.size());
+    auto bucket_of = [&](id_type u) { return static_cast<size_type>(dist[u].load(std::memory_order_relaxed) / delta); };
+    auto relax = [&](const std::vector<id_type> &from, bool light) {
+        pool.parallel_for(0, from.size(), [&](size_t i, unsigned t) {
+            id_type u = from[i];
+            edge du = dist[u].load(std::memory_order_relaxed);
+            size_type relaxed = 0;
+            for (size_type e = offsets[u]; e < offsets[u + 1]; ++e) {
+                if (light == (delta < weights[e]))
+                    continue;
+                ++relaxed;
+                edge dv = du + weights[e];
+                std::atomic<edge> &target = dist[targets[e]];
+                edge old = target.load(std::memory_order_relaxed);
+                while (dv < old) {
+                    if (target.compare_exchange_weak(old, dv, std::memory_order_relaxed)) {
+                        improved[t].push_back(targets[e]);
+                        break;
+                    }
+                }
+            }
+            GRAPH_COUNT(relaxations, relaxed);
+        }, 64);
+    };
+
+    std::map<size_type, std::vector<id_type>> buckets;
+    buckets[0].push_back(s);
+    std::vector<size_type> seen(n, 0), done(n, 0);
+    std::vector<id_type> frontier, settled;
+    size_type round = 0, phase = 0;
+
+    while (!buckets.empty()) {
+        size_type current = buckets.begin()->first;
+        std::vector<id_type> pending = std::move(buckets.begin()->second);
+        buckets.erase(buckets.begin());
+        settled.clear();
+        ++phase;
+
+        while (!pending.empty()) {
+            // Drop duplicates and vertices that have since moved to a lower bucket
+            ++round;
+            frontier.clear();
+            for (id_type u : pending) {
+                if (seen[u] != round && bucket_of(u) == current) {
+                    seen[u] = round;
+                    frontier.push_back(u);
+                    if (done[u] != phase) {
+                        done[u] = phase;
+                        settled.push_back(u);
+                    }
+                }
+            }
+            pending.clear();
+
+            relax(frontier, true);
+            for (std::vector<id_type> &list : improved) {
+                for (id_type v : list) {
+                    size_type b = bucket_of(v);
+                    if (b == current)
+                        pending.push_back(v);
+                    else
+                        buckets[b].push_back(v);
+                }
+                list.clear();
+            }
+        }
+
+        GRAPH_COUNT(vertices_visited, settled.size());
+        relax(settled, false);
+        for (std::vector<id_type> &list : improved) {
+            for (id_type v : list)
+                buckets[bucket_of(v)].push_back(v);
+            list.clear();
+        }
+    }
+
+    for (size_type u = 0; u < n; ++u)
+        tree.distance[u] = dist[u].load(std::memory_order_relaxed);
+
+    // Parents follow tight edges breadth first from the source, which stays acyclic with zero weights
+    std::vector<std::atomic<id_type>> parent(n);
+    for (size_type u = 0; u < n; ++u)
+        parent[u].store(npos, std::memory_order_relaxed);
+    parent[s].store(s, std::memory_order_relaxed);
+    frontier.assign(1, s);
+    while (!frontier.empty()) {
+        pool.parallel_for(0, frontier.size(), [&](size_t i, unsigned t) {
+            id_type u = frontier[i];
+            for (size_type e = offsets[u]; e < offsets[u + 1]; ++e) {
+                id_type v = targets[e];
+                id_type unset = npos;
+                if (tree.distance[u] + weights[e] == tree.distance[v] && parent[v].load(std::memory_order_relaxed) == npos &&
+                    parent[v].compare_exchange_strong(unset, u, std::memory_order_relaxed))
+                    improved[t].push_back(v);
+            }
+        }, 64);
+        frontier.clear();
+        for (std::vector<id_type> &list : improved) {
+            frontier.insert(frontier.end(), list.begin(), list.end());
+            list.clear();
+        }
+    }
+    for (size_type u = 0; u < n; ++u)
+        tree.parent[u] = parent[u].load(std::memory_order_relaxed);
+    return tree;
+}
+
+/**
+ * Finds the shortest path from the given source vertex to all other vertices using Dijkstra's algorithm.
+ * Adapter over shortest_paths() returning the format of Graph::dijkstra.
+ *
+ * @param src The source vertex from which to find the shortest path.
+ *
+ * @return A map of vertices to pairs containing the previous vertex and the weight of the shortest path.
+ */
+template <typename vertex, typename edge>
+std::map<vertex, std::pair<vertex, edge>> CsrGraph<vertex, edge>::dijkstra(const vertex &src) const {
+    ShortestPathEngine<vertex, edge> engine(*this);
+    engine.run(id(src));
+    std::map<vertex, std::pair<vertex, edge>> path = engine.to_map();
+    if (id(src) == npos)
+        path[src] = std::make_pair(src, edge());
+    return path;
+}
+
+/**
+ * Finds the shortest path between two vertices, stopping as soon as the destination is settled.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param bidirectional Search from both ends at once and stop when the two searches meet.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge>
+std::pair<edge, std::vector<vertex>> CsrGraph<vertex, edge>::shortest_path(const vertex &src, const vertex &dst, bool bidirectional) const {
+    ShortestPathEngine<vertex, edge> engine(*this);
+    std::pair<edge, std::vector<vertex>> result;
+    result.first = bidirectional ? engine.run_bidirectional(id(src), id(dst)) : engine.run(id(src), id(dst));
+    for (id_type u : engine.path_to(id(dst)))
+        result.second.push_back(names.vertex_at(u));
+    return result;
+}
+
+/**
+ * Finds the shortest path between two vertices with A* search.
+ * The heuristic must never overestimate the remaining distance.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param h Callable h(node, dst) returning a lower bound of the distance from node to dst.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge>
+template <typename heuristic>
+std::pair<edge, std::vector<vertex>> CsrGraph<vertex, edge>::astar(const vertex &src, const vertex &dst, heuristic h) const {
+    ShortestPathEngine<vertex, edge> engine(*this);
+    std::pair<edge, std::vector<vertex>> result;
+    result.first = engine.run_astar(id(src), id(dst), [&](id_type u, id_type goal) { return h(names.vertex_at(u), names.vertex_at(goal)); });
+    for (id_type u : engine.path_to(id(dst)))
+        result.second.push_back(names.vertex_at(u));
+    return result;
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+
+// Shortest path tree from one source that follows the edge updates of a Graph, repairing only the
+// part of the tree an update affects (Ramalingam and Reps, "An incremental algorithm for a
+// generalization of the shortest-path problem"). A shorter edge starts a Dijkstra search from its
+// head that stops where distances no longer drop; a longer or deleted tree edge detaches the subtree
+// below it, which is reattached through its cheapest edges from the rest of the tree.
+// Updates must go through this class while it is in use; directed graphs need Direction::bidirectional.
+template <typename vertex = int,                         // DynamicShortestPaths::vertex_type
+          typename edge = double,                        // DynamicShortestPaths::edge_type
+          Direction direction = Direction::undirected    // DynamicShortestPaths::orientation
+          >
+class DynamicShortestPaths {
+    static_assert(direction != Direction::directed, "repairing a tree needs the reverse index of Direction::bidirectional");
+
+public:
+    typedef vertex vertex_type;
+    typedef edge edge_type;
+    typedef size_t size_type;
+
+private:
+    typedef std::priority_queue<std::pair<vertex, edge>, std::vector<std::pair<vertex, edge>>, reverseWeightedOrder<vertex, edge>> min_queue;
+
+    Graph<vertex, edge, direction> &network;
+    vertex src;
+
+    // Reached vertices mapped to their parent in the tree and their distance from src
+    std::unordered_map<vertex, std::pair<vertex, edge>> tree;
+
+    min_queue q;
+    std::vector<vertex> subtree;
+    size_type affected;
+
+    bool lower(const vertex &, const vertex &, const edge &);
+    void propagate();
+    void detach(const vertex &);
+    void repair(const vertex &, const vertex &, const edge &, const edge &);
+    bool weight_of(const vertex &, const vertex &, edge &);
+
+public:
+    DynamicShortestPaths(Graph<vertex, edge, direction> &, const vertex &);
+
+    void add_edge(const vertex &, const vertex &, const edge = edge_type());
+    void delete_edge(const vertex &, const vertex &);
+    void modify_edge(const vertex &, const vertex &, const edge = edge_type());
+
+    const vertex &source() const;
+    bool reachable(const vertex &) const;
+    edge distance(const vertex &) const;
+    const vertex &parent(const vertex &) const;
+    std::vector<vertex> path_to(const vertex &) const;
+    size_type last_affected() const;
+};
+
+/**
+ * Computes the shortest path tree of a graph from a source with Dijkstra's algorithm.
+ *
+ * @param graph The graph to follow, which must outlive the tree.
+ * @param source The vertex the paths start from.
+ */
+template <typename vertex, typename edge, Direction direction>
+DynamicShortestPaths<vertex, edge, direction>::DynamicShortestPaths(Graph<vertex, edge, direction> &graph, const vertex &source)
+    : network(graph), src(source), affected(0) {
+    tree[src] = std::make_pair(src, edge());
+    q.push(std::make_pair(src, edge()));
+    propagate();
+}
+
+/**
+ * Makes u the parent of v if the path through the edge between them is shorter.
+ *
+ * @param u The vertex the edge leaves from, part of the tree.
+ * @param v The vertex the edge leads to.
+ * @param weight The weight of the edge.
+ *
+ * @return true if the distance of v dropped, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool DynamicShortestPaths<vertex, edge, direction>::lower(const vertex &u, const vertex &v, const edge &weight) {
+    edge dv = tree[u].second + weight;
+    typename std::unordered_map<vertex, std::pair<vertex, edge>>::iterator it = tree.find(v);
+    if (it != tree.end() && !(dv < it->second.second))
+        return false;
+    tree[v] = std::make_pair(u, dv);
+    q.push(std::make_pair(v, dv));
+    GRAPH_COUNT(heap_operations, 1);
+    return true;
+}
+
+/**
+ * Settles the queued vertices in order of distance, relaxing their out-edges. Vertices whose distance
+ * does not drop are never queued, so the search ends at the border of the affected region.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void DynamicShortestPaths<vertex, edge, direction>::propagate() {
+    while (!q.empty()) {
+        std::pair<vertex, edge> top = q.top();
+        q.pop();
+        if (tree[top.first].second < top.second)
+            continue;
+        ++affected;
+        GRAPH_COUNT(vertices_visited, 1);
+
+        typename Graph<vertex, edge, direction>::iterator it = network.find(top.first);
+        if (it == network.end())
+            continue;
+        GRAPH_COUNT(relaxations, it->second.size());
+        for (const std::pair<vertex, edge> &x : it->second)
+            lower(top.first, x.first, x.second);
+    }
+}
+
+/**
+ * Removes the subtree hanging below a vertex from the tree, then queues every vertex of it that can
+ * still be reached through an edge from outside, with the shortest such distance.
+ *
+ * @param root The vertex whose tree edge got longer or was deleted.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void DynamicShortestPaths<vertex, edge, direction>::detach(const vertex &root) {
+    // Children are the out-neighbours whose parent is the current vertex
+    subtree.assign(1, root);
+    for (size_type head = 0; head < subtree.size(); ++head) {
+        vertex u = subtree[head];
+        typename Graph<vertex, edge, direction>::iterator it = network.find(u);
+        if (it == network.end())
+            continue;
+        for (const std::pair<vertex, edge> &x : it->second) {
+            typename std::unordered_map<vertex, std::pair<vertex, edge>>::iterator child = tree.find(x.first);
+            if (child != tree.end() && child->second.first == u && !(x.first == u) && !(x.first == src))
+                subtree.push_back(x.first);
+        }
+    }
+    for (const vertex &u : subtree)
+        tree.erase(u);
+
+    for (const vertex &v : subtree) {
+        for (const std::pair<vertex, edge> &p : network.predecessors(v)) {
+            if (tree.find(p.first) != tree.end())
+                lower(p.first, v, p.second);
+        }
+    }
+    affected += subtree.size();
+}
+
+/**
+ * Looks up the weight of the edge from one vertex to another.
+ *
+ * @param u The vertex the edge leaves from.
+ * @param v The vertex the edge leads to.
+ * @param weight Receives the weight.
+ *
+ * @return true if the edge exists, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool DynamicShortestPaths<vertex, edge, direction>::weight_of(const vertex &u, const vertex &v, edge &weight) {
+    typename Graph<vertex, edge, direction>::iterator it = network.find(u);
+    if (it == network.end())
+        return false;
+    typename std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>::const_iterator e = it->second.find(std::make_pair(v, edge()));
+    if (e == it->second.end())
+        return false;
+    weight = e->second;
+    return true;
+}
+
+/**
+ * Repairs the tree after the edge between two vertices changed from one weight to another,
+ * INF standing for a missing edge.
+ *
+ * @param u The vertex the edge leaves from.
+ * @param v The vertex the edge leads to.
+ * @param old_weight The weight before the update.
+ * @param new_weight The weight after the update.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void DynamicShortestPaths<vertex, edge, direction>::repair(const vertex &u, const vertex &v, const edge &old_weight, const edge &new_weight) {
+    affected = 0;
+    if (u == v || old_weight == new_weight)
+        return;
+
+    if (new_weight < old_weight) {
+        if (tree.find(u) != tree.end())
+            lower(u, v, new_weight);
+        if (direction == Direction::undirected && tree.find(v) != tree.end())
+            lower(v, u, new_weight);
+    } else {
+        // Only a tree edge can make paths longer
+        typename std::unordered_map<vertex, std::pair<vertex, edge>>::iterator it = tree.find(v);
+        if (it != tree.end() && it->second.first == u && !(v == src)) {
+            detach(v);
+        } else if (direction == Direction::undirected) {
+            it = tree.find(u);
+            if (it != tree.end() && it->second.first == v && !(u == src))
+                detach(u);
+        }
+    }
+    propagate();
+}
+
+/**
+ * Adds an edge to the graph and repairs the tree. Like Graph::add_edge, an existing edge keeps its weight.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ * @param weight The weight of the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void DynamicShortestPaths<vertex, edge, direction>::add_edge(const vertex &node1, const vertex &node2, const edge weight) {
+    if (network.has_edge(node1, node2)) {
+        affected = 0;
+        return;
+    }
+    network.add_edge(node1, node2, weight);
+    repair(node1, node2, INF, weight);
+}
+
+/**
+ * Deletes an edge from the graph and repairs the tree.
+ *
+ * @param node1 The first node of the edge to be deleted.
+ * @param node2 The second node of the edge to be deleted.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void DynamicShortestPaths<vertex, edge, direction>::delete_edge(const vertex &node1, const vertex &node2) {
+    edge old_weight;
+    if (!weight_of(node1, node2, old_weight)) {
+        affected = 0;
+        return;
+    }
+    network.delete_edge(node1, node2);
+    repair(node1, node2, old_weight, INF);
+}
+
+/**
+ * Changes the weight of an edge, adding it if it does not exist, and repairs the tree.
+ *
+ * @param node1 The first node of the edge to be modified.
+ * @param node2 The second node of the edge to be modified.
+ * @param new_weight The new weight for the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void DynamicShortestPaths<vertex, edge, direction>::modify_edge(const vertex &node1, const vertex &node2, const edge new_weight) {
+    edge old_weight;
+    if (!weight_of(node1, node2, old_weight))
+        old_weight = INF;
+    network.modify_edge(node1, node2, new_weight);
+    repair(node1, node2, old_weight, new_weight);
+}
+
+/**
+ * Returns the vertex every path starts from.
+ *
+ * @return The source vertex.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &DynamicShortestPaths<vertex, edge, direction>::source() const {
+    return src;
+}
+
+/**
+ * Checks if a path from the source to a vertex exists.
+ *
+ * @param node The vertex to check.
+ *
+ * @return true if the vertex is part of the tree, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool DynamicShortestPaths<vertex, edge, direction>::reachable(const vertex &node) const {
+    return tree.find(node) != tree.end();
+}
+
+/**
+ * Returns the length of the shortest path from the source to a vertex.
+ *
+ * @param node The vertex to look up.
+ *
+ * @return The distance, or INF if the vertex cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+edge DynamicShortestPaths<vertex, edge, direction>::distance(const vertex &node) const {
+    typename std::unordered_map<vertex, std::pair<vertex, edge>>::const_iterator it = tree.find(node);
+    return it == tree.end() ? edge(INF) : it->second.second;
+}
+
+/**
+ * Returns the previous vertex on the shortest path to a vertex.
+ *
+ * @param node A vertex that can be reached.
+ *
+ * @return The parent of the vertex in the tree, the source for itself.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &DynamicShortestPaths<vertex, edge, direction>::parent(const vertex &node) const {
+    return tree.at(node).first;
+}
+
+/**
+ * Returns the vertices on the shortest path from the source to a vertex.
+ *
+ * @param node The destination vertex.
+ *
+ * @return The path from the source to node, or an empty vector if node cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::vector<vertex> DynamicShortestPaths<vertex, edge, direction>::path_to(const vertex &node) const {
+    std::vector<vertex> path;
+    if (!reachable(node))
+        return path;
+    for (vertex u = node; !(u == src); u = tree.at(u).first)
+        path.push_back(u);
+    path.push_back(src);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/**
+ * Returns how many vertices the last update touched, a measure of the work it did.
+ *
+ * @return The number of vertices settled or detached by the last update.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename DynamicShortestPaths<vertex, edge, direction>::size_type DynamicShortestPaths<vertex, edge, direction>::last_affected() const {
+    return affected;
+}
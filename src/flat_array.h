@@ -0,0 +1,184 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Read-only array that either owns its elements or views memory kept alive by someone else,
+// e.g. a mapped file, so both kinds of storage are read through the same pointer
+template <typename value // FlatArray::value_type
+          >
+class FlatArray {
+public:
+    typedef value value_type;
+    typedef size_t size_type;
+    typedef const value *const_iterator;
+
+private:
+    std::vector<value> owned;
+
+    // owned.data() or memory held alive by keeper
+    const value *items;
+    size_type count;
+    std::shared_ptr<const void> keeper;
+
+public:
+    FlatArray();
+    explicit FlatArray(std::vector<value> &&);
+    FlatArray(const value *, size_type, std::shared_ptr<const void>);
+    FlatArray(const FlatArray &);
+    FlatArray(FlatArray &&);
+    FlatArray &operator=(const FlatArray &);
+    FlatArray &operator=(FlatArray &&);
+
+    size_type size() const;
+    bool empty() const;
+    const value &operator[](size_type) const;
+    const value *data() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+};
+
+/**
+ * Constructs an empty array.
+ */
+template <typename value>
+FlatArray<value>::FlatArray() : items(nullptr), count(0) {}
+
+/**
+ * Takes over the elements of a vector.
+ *
+ * @param elements The elements to own.
+ */
+template <typename value>
+FlatArray<value>::FlatArray(std::vector<value> &&elements) : owned(std::move(elements)), items(owned.data()), count(owned.size()) {}
+
+/**
+ * Views elements owned elsewhere.
+ *
+ * @param first Pointer to the first element.
+ * @param n The number of elements.
+ * @param keeper_ Keeps the memory of the elements alive as long as any copy of the array exists.
+ */
+template <typename value>
+FlatArray<value>::FlatArray(const value *first, size_type n, std::shared_ptr<const void> keeper_)
+    : items(first), count(n), keeper(std::move(keeper_)) {}
+
+/**
+ * Copies an array. Owned elements are copied, viewed elements are shared.
+ *
+ * @param other The array to copy.
+ */
+template <typename value>
+FlatArray<value>::FlatArray(const FlatArray &other) : owned(other.owned), items(other.items), count(other.count), keeper(other.keeper) {
+    if (!keeper)
+        items = owned.data();
+}
+
+/**
+ * Moves an array, leaving the source empty.
+ *
+ * @param other The array to move.
+ */
+template <typename value>
+FlatArray<value>::FlatArray(FlatArray &&other)
+    : owned(std::move(other.owned)), items(other.items), count(other.count), keeper(std::move(other.keeper)) {
+    other.items = nullptr;
+    other.count = 0;
+}
+
+/**
+ * Replaces the elements with those of another array.
+ *
+ * @param other The array to copy.
+ *
+ * @return This array.
+ */
+template <typename value>
+FlatArray<value> &FlatArray<value>::operator=(const FlatArray &other) {
+    if (this != &other)
+        *this = FlatArray(other);
+    return *this;
+}
+
+/**
+ * Takes over the elements of another array, leaving it empty.
+ *
+ * @param other The array to move.
+ *
+ * @return This array.
+ */
+template <typename value>
+FlatArray<value> &FlatArray<value>::operator=(FlatArray &&other) {
+    if (this != &other) {
+        owned = std::move(other.owned);
+        items = other.items;
+        count = other.count;
+        keeper = std::move(other.keeper);
+        other.items = nullptr;
+        other.count = 0;
+    }
+    return *this;
+}
+
+/**
+ * Returns the number of elements.
+ *
+ * @return The size of the array.
+ */
+template <typename value>
+typename FlatArray<value>::size_type FlatArray<value>::size() const {
+    return count;
+}
+
+/**
+ * Checks if the array is empty.
+ *
+ * @return true if there are no elements, false otherwise.
+ */
+template <typename value>
+bool FlatArray<value>::empty() const {
+    return count == 0;
+}
+
+/**
+ * Returns an element.
+ *
+ * @param i An index smaller than size().
+ *
+ * @return The element at index i.
+ */
+template <typename value>
+const value &FlatArray<value>::operator[](size_type i) const {
+    return items[i];
+}
+
+/**
+ * Returns a pointer to the contiguous elements.
+ *
+ * @return Pointer to the first element.
+ */
+template <typename value>
+const value *FlatArray<value>::data() const {
+    return items;
+}
+
+/**
+ * Returns an iterator to the first element.
+ *
+ * @return Pointer to the first element.
+ */
+template <typename value>
+typename FlatArray<value>::const_iterator FlatArray<value>::begin() const {
+    return items;
+}
+
+/**
+ * Returns an iterator past the last element.
+ *
+ * @return Pointer past the last element.
+ */
+template <typename value>
+typename FlatArray<value>::const_iterator FlatArray<value>::end() const {
+    return items + count;
+}
@@ -1,11 +1,25 @@
+#pragma once
+
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <queue>
 #include <set>
-#include <stack>
+#include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+#include "instrumentation.h"
+
 #define INF INT32_MAX
 
 template <typename vertex, typename edge>
@@ -18,105 +32,378 @@ struct uniquePair {
 template <typename vertex, typename edge>
 struct weightedOrder {
     bool operator()(const std::pair<vertex, edge> &lhs, const std::pair<vertex, edge> &rhs) const {
-        return (lhs.second < rhs.second) || (!(lhs.second < rhs.second) && (lhs.first < rhs.first));
+        return (lhs.second < rhs.second) || (!(rhs.second < lhs.second) && (lhs.first < rhs.first));
+    }
+};
+
+// Inverse of weightedOrder, turns std::priority_queue into a min-heap on edge weights
+template <typename vertex, typename edge>
+struct reverseWeightedOrder {
+    bool operator()(const std::pair<vertex, edge> &lhs, const std::pair<vertex, edge> &rhs) const {
+        return weightedOrder<vertex, edge>()(rhs, lhs);
     }
 };
 
-template <typename vertex = int, // Graph::vertex_type
-          typename edge = double // Graph::edge_type
+// Heuristic estimating every remaining distance as zero, which turns A* into Dijkstra's algorithm
+template <typename edge>
+struct zeroHeuristic {
+    template <typename node>
+    edge operator()(const node &, const node &) const {
+        return edge();
+    }
+};
+
+// Sentinel ending the lazy traversal ranges of a Graph
+struct traversalEnd {};
+
+// Base of the lazy traversal ranges; from C++20 on it marks them as views, so std::views adaptors take
+// them by value and stop the traversal as soon as they stop asking for vertices
+#if __cplusplus >= 202002L
+typedef std::ranges::view_base traversalViewBase;
+#else
+struct traversalViewBase {};
+#endif
+
+// Whether edges have a direction, and whether a directed graph also indexes the edges entering each vertex
+enum class Direction {
+    // Every edge is stored in the neighbor sets of both endpoints
+    undirected,
+
+    // Edges are stored only in the neighbor set of the vertex they leave
+    directed,
+
+    // Like directed, plus a reverse index of the edges entering every vertex
+    bidirectional
+};
+
+template <typename vertex, typename edge>
+class CsrGraph;
+
+template <typename edge>
+struct ShortestPathTree;
+
+template <typename edge>
+struct SpanningTree;
+
+template <typename vertex, typename edge>
+class ShortestPathEngine;
+
+template <typename vertex = int,                          // Graph::vertex_type
+          typename edge = double,                         // Graph::edge_type
+          Direction direction = Direction::undirected     // Graph::orientation
           >
 class Graph {
 private:
+    // Map of every vertex to a set of (neighbour, weight) pairs
+    typedef std::pmr::unordered_map<vertex, std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>> adjacency_map;
+
     // Map key stores the vertex
-    // Map value is a set of connected vertices with corresponding edge weights
-    std::unordered_map<vertex, std::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>> network;
+    // Map value is a set of connected vertices with corresponding edge weights, for directed graphs
+    // only the vertices the edges leave to
+    adjacency_map network;
+
+    // Vertices the edges entering every vertex come from, only filled for Direction::bidirectional
+    adjacency_map reverse;
+
+    // Snapshot dijkstra() searches, frozen on first use and dropped by every call that can change the graph,
+    // including the non-const accessors handing out neighbor sets; copies of the graph share it
+    std::shared_ptr<const CsrGraph<vertex, edge>> snapshot;
 
     // An iterator to value of network map
-    typedef typename std::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>::iterator set_iterator;
+    typedef typename std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>::iterator set_iterator;
+
+    // Priority queue of (vertex, tentative distance) pairs with lazy deletion
+    typedef std::priority_queue<std::pair<vertex, edge>, std::vector<std::pair<vertex, edge>>, reverseWeightedOrder<vertex, edge>> min_queue;
+
+    // isConnected finds the entry of a vertex in a neighbor set, ordered by vertex so the lookup is logarithmic
+    set_iterator isConnected(const std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &, const vertex &) const;
+
+    // Changes the weight of a neighbor set entry without moving it
+    void reweight(std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &, set_iterator, const edge &);
+
+    // Sorts (vertex, neighbour, weight) arcs and inserts them into an adjacency map one vertex at a time
+    void insert_arcs(adjacency_map &, std::vector<std::tuple<vertex, vertex, edge>> &, bool);
 
-    // isConnected checks if 2 vertices are connected by one or more edges
-    set_iterator isConnected(const vertex &, const vertex &);
+    // Relaxes every edge of the closest vertex in the queue, reports the settled vertex
+    template <typename heuristic>
+    bool settle(const adjacency_map &, min_queue &, std::unordered_map<vertex, std::pair<vertex, edge>> &, std::pair<vertex, edge> &, heuristic &,
+                const vertex &) const;
+
+    // Names the values of a per dense id array computed on a snapshot by their vertices
+    static std::map<vertex, double> by_vertex(const CsrGraph<vertex, edge> &, const std::vector<double> &);
 
 public:
     typedef vertex vertex_type;
     typedef edge edge_type;
-    typedef std::pair<const vertex, std::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>> list_type;
-    typedef typename std::unordered_map<vertex, std::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>>::iterator iterator;
+    typedef std::pair<const vertex, std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>> list_type;
+    typedef typename std::pmr::unordered_map<vertex, std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>>::iterator iterator;
     typedef size_t size_type;
 
+    static constexpr Direction orientation = direction;
+
+    Graph();
+    explicit Graph(std::pmr::memory_resource *);
+
     void add_edge(const vertex &, const vertex &, const edge = edge_type());
     void delete_edge(const vertex, const vertex);
     void modify_edge(const vertex, const vertex, const edge = edge_type());
-    typename Graph<vertex, edge>::iterator find(const vertex);
+    bool has_edge(const vertex &, const vertex &) const;
+    const std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &predecessors(const vertex &) const;
+    template <typename input_iterator>
+    void add_edges(input_iterator, input_iterator, bool = false);
+    typename Graph<vertex, edge, direction>::iterator find(const vertex);
     std::map<vertex, std::pair<vertex, edge>> dijkstra(const vertex &);
-    Graph<vertex, edge>::size_type size() const;
+    std::pair<edge, std::vector<vertex>> shortest_path(const vertex &, const vertex &, bool = false) const;
+    template <typename heuristic>
+    std::pair<edge, std::vector<vertex>> astar(const vertex &, const vertex &, heuristic) const;
+    std::pair<edge, std::vector<std::tuple<vertex, vertex, edge>>> minimum_spanning_tree(unsigned = 1) const;
+    std::map<vertex, double> page_rank(double = 0.85, double = 1e-6, unsigned = 0) const;
+    std::map<vertex, double> degree_centrality() const;
+    std::map<vertex, double> betweenness_centrality(bool = false, unsigned = 0) const;
+    Graph<vertex, edge, direction>::size_type size() const;
     bool empty() const;
+    CsrGraph<vertex, edge> freeze() const;
+    void save(const std::string &) const;
 
     iterator begin();
     iterator end();
     void display();
 
+    class breadth_first_search_iterator;
+    class depth_first_search_iterator;
+    class breadth_first_search_range;
+    class depth_first_search_range;
+    class dijkstra_range;
+
+    breadth_first_search_range bfs(const vertex &);
+    depth_first_search_range dfs(const vertex &);
+    dijkstra_range dijkstra_settled(const vertex &) const;
+    std::vector<std::pair<vertex, edge>> nearest(const vertex &, size_type, const edge & = std::numeric_limits<edge>::max()) const;
+    std::vector<std::pair<vertex, edge>> within(const vertex &, const edge &) const;
+
+    // Visited set and frontier shared by the traversals started with it, kept between traversals
+    // so that starting one allocates nothing once the context has seen the graph
+    class traversal_context {
+    private:
+        // Open addressing table of visited vertices, a slot belongs to the current traversal if its
+        // stamp equals epoch, so older slots count as empty and the table never has to be cleared
+        std::vector<vertex> keys;
+        std::vector<unsigned> stamp;
+        unsigned epoch;
+        size_t count;
+
+        // Queue (from head onwards) of a breadth first or stack of a depth first traversal
+        std::vector<Graph<vertex, edge, direction>::iterator> frontier;
+        size_t head;
+
+        void start();
+        void grow();
+        size_t slot(const vertex &) const;
+        bool visit(const vertex &);
+        bool visited(const vertex &) const;
+
+        friend class breadth_first_search_iterator;
+        friend class depth_first_search_iterator;
+
+    public:
+        traversal_context();
+    };
+
+    // Input iterator: copies share the traversal, so advancing one copy advances all of them
     class breadth_first_search_iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Graph<vertex, edge, direction>::list_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Graph<vertex, edge, direction>::iterator pointer;
+        typedef Graph<vertex, edge, direction>::list_type &reference;
+
     private:
-        std::unordered_map<vertex, bool> visited;
-        std::queue<Graph<vertex, edge>::iterator> q;
-        typename Graph<vertex, edge>::iterator it;
-        Graph<vertex, edge> &obj;
+        std::shared_ptr<traversal_context> owned;
+        traversal_context *ctx;
+        Graph<vertex, edge, direction> &obj;
+        typename Graph<vertex, edge, direction>::iterator it;
+
+        void start();
 
     public:
-        breadth_first_search_iterator(Graph<vertex, edge> &, Graph<vertex, edge>::iterator);
+        breadth_first_search_iterator(Graph<vertex, edge, direction> &, Graph<vertex, edge, direction>::iterator);
+        breadth_first_search_iterator(Graph<vertex, edge, direction> &, Graph<vertex, edge, direction>::iterator, traversal_context &);
 
         breadth_first_search_iterator &operator++();
         breadth_first_search_iterator operator++(int);
-        Graph<vertex, edge>::list_type &operator*();
-        typename Graph<vertex, edge>::iterator operator->();
+        Graph<vertex, edge, direction>::list_type &operator*();
+        typename Graph<vertex, edge, direction>::iterator operator->();
         bool operator==(const breadth_first_search_iterator &) const;
         bool operator!=(const breadth_first_search_iterator &) const;
         bool bfsend();
     };
 
+    // Input iterator: copies share the traversal, so advancing one copy advances all of them
     class depth_first_search_iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Graph<vertex, edge, direction>::list_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Graph<vertex, edge, direction>::iterator pointer;
+        typedef Graph<vertex, edge, direction>::list_type &reference;
+
     private:
-        std::unordered_map<vertex, bool> visited;
-        std::stack<Graph<vertex, edge>::iterator> st;
-        typename Graph<vertex, edge>::iterator it;
-        Graph<vertex, edge> &obj;
+        std::shared_ptr<traversal_context> owned;
+        traversal_context *ctx;
+        Graph<vertex, edge, direction> &obj;
+        typename Graph<vertex, edge, direction>::iterator it;
+
+        void start();
 
     public:
-        depth_first_search_iterator(Graph<vertex, edge> &, Graph<vertex, edge>::iterator);
+        depth_first_search_iterator(Graph<vertex, edge, direction> &, Graph<vertex, edge, direction>::iterator);
+        depth_first_search_iterator(Graph<vertex, edge, direction> &, Graph<vertex, edge, direction>::iterator, traversal_context &);
 
         depth_first_search_iterator &operator++();
         depth_first_search_iterator operator++(int);
-        Graph<vertex, edge>::list_type &operator*();
-        typename Graph<vertex, edge>::iterator operator->();
+        Graph<vertex, edge, direction>::list_type &operator*();
+        typename Graph<vertex, edge, direction>::iterator operator->();
         bool operator==(const depth_first_search_iterator &rhs) const;
         bool operator!=(const depth_first_search_iterator &rhs) const;
         bool dfsend();
     };
+
+    // Input iterator over a lazy traversal range, reading and advancing the traversal the range holds;
+    // the comparisons with traversalEnd are hidden friends so that they work both ways round
+    template <typename range, typename value>
+    class traversal_iterator {
+    private:
+        range *owner;
+
+        bool at_end() const;
+
+    public:
+        typedef value value_type;
+        typedef const value &reference;
+        typedef const value *pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::input_iterator_tag iterator_category;
+
+        explicit traversal_iterator(range * = nullptr);
+
+        reference operator*() const;
+        pointer operator->() const;
+        traversal_iterator &operator++();
+        void operator++(int);
+
+        friend bool operator==(const traversal_iterator &it, traversalEnd) { return it.at_end(); }
+        friend bool operator==(traversalEnd, const traversal_iterator &it) { return it.at_end(); }
+        friend bool operator!=(const traversal_iterator &it, traversalEnd) { return !it.at_end(); }
+        friend bool operator!=(traversalEnd, const traversal_iterator &it) { return !it.at_end(); }
+    };
+
+    // Vertices in breadth first order, discovered one vertex at a time as the range is iterated
+    class breadth_first_search_range : public traversalViewBase {
+    public:
+        typedef traversal_iterator<breadth_first_search_range, vertex> iterator;
+
+    private:
+        // Null if the source is not part of the graph
+        std::unique_ptr<breadth_first_search_iterator> walk;
+
+        const vertex &current() const;
+        void advance();
+        bool finished() const;
+
+        friend iterator;
+
+    public:
+        breadth_first_search_range(Graph<vertex, edge, direction> &, const vertex &);
+
+        iterator begin();
+        traversalEnd end() const;
+    };
+
+    // Vertices in depth first order, discovered one vertex at a time as the range is iterated
+    class depth_first_search_range : public traversalViewBase {
+    public:
+        typedef traversal_iterator<depth_first_search_range, vertex> iterator;
+
+    private:
+        // Null if the source is not part of the graph
+        std::unique_ptr<depth_first_search_iterator> walk;
+
+        const vertex &current() const;
+        void advance();
+        bool finished() const;
+
+        friend iterator;
+
+    public:
+        depth_first_search_range(Graph<vertex, edge, direction> &, const vertex &);
+
+        iterator begin();
+        traversalEnd end() const;
+    };
+
+    // (vertex, distance) pairs in the order Dijkstra's algorithm settles them, each step settling one
+    // more vertex, so reading the k nearest vertices only pays for those k
+    class dijkstra_range : public traversalViewBase {
+    public:
+        typedef traversal_iterator<dijkstra_range, std::pair<vertex, edge>> iterator;
+
+    private:
+        const Graph<vertex, edge, direction> *obj;
+        vertex src;
+        min_queue q;
+        std::unordered_map<vertex, std::pair<vertex, edge>> path;
+        std::pair<vertex, edge> top;
+        bool done;
+
+        const std::pair<vertex, edge> &current() const;
+        void advance();
+        bool finished() const;
+
+        friend iterator;
+
+    public:
+        dijkstra_range(const Graph<vertex, edge, direction> &, const vertex &);
+
+        iterator begin();
+        traversalEnd end() const;
+        const vertex &parent(const vertex &) const;
+    };
 };
 
 /**
- * Checks if two nodes in the graph are connected.
+ * Constructs an empty graph allocating from the default memory resource.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::Graph() {}
+
+/**
+ * Constructs an empty graph whose vertices and neighbor sets are allocated from a memory resource,
+ * e.g. a GraphArena to build a graph and free it in one go. The resource must outlive the graph.
+ *
+ * @param resource The memory resource used by the adjacency containers.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::Graph(std::pmr::memory_resource *resource) : network(resource), reverse(resource) {}
+
+/**
+ * Finds the entry of a node in the neighbor set of another node.
  *
- * @param node1 The first node to check.
- * @param node2 The second node to check.
+ * @param neighbors The neighbor set of the first node.
+ * @param node2 The node to look up.
  *
- * @return An iterator pointing to the edge connecting the two nodes, or the end iterator if no such edge exists.
+ * @return An iterator pointing to the edge leading to node2, or the end iterator of neighbors if no such edge exists.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::set_iterator Graph<vertex, edge>::isConnected(const vertex &node1, const vertex &node2) {
-    Graph<vertex, edge>::set_iterator b = network[node1].begin();
-    Graph<vertex, edge>::set_iterator e = network[node1].end();
-    while (b != e) {
-        if (b->first == node2)
-            break;
-        ++b;
-    }
-    return b;
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::set_iterator Graph<vertex, edge, direction>::isConnected(const std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &neighbors,
+                                                                            const vertex &node2) const {
+    // uniquePair only compares vertices, so the weight of the probe is irrelevant
+    return neighbors.find(std::make_pair(node2, edge()));
 }
 
 /**
  * Adds an edge between two nodes in the graph with the given weight.
+ * Edges of a directed graph lead from node1 to node2, node2 still becomes a vertex of the graph.
  *
  * @param node1 The first node of the edge.
  * @param node2 The second node of the edge.
@@ -124,51 +411,213 @@ typename Graph<vertex, edge>::set_iterator Graph<vertex, edge>::isConnected(cons
  *
  * @return void
  */
-template <typename vertex, typename edge>
-void Graph<vertex, edge>::add_edge(const vertex &node1, const vertex &node2, const edge weight) {
-    std::cout << "Adding vertex: <" << node1 << "," << node2 << "," << weight << ">" << '\n';
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::add_edge(const vertex &node1, const vertex &node2, const edge weight) {
+    GRAPH_LOG("Adding vertex: <" << node1 << "," << node2 << "," << weight << ">");
+    GRAPH_COUNT(edges_added, 1);
+    snapshot.reset();
     network[node1].insert(std::make_pair(node2, weight));
-    network[node2].insert(std::make_pair(node1, weight));
+    if constexpr (direction == Direction::undirected) {
+        network[node2].insert(std::make_pair(node1, weight));
+    } else {
+        network[node2];
+        if constexpr (direction == Direction::bidirectional)
+            reverse[node2].insert(std::make_pair(node1, weight));
+    }
 }
 
 /**
- * Deletes an edge between two nodes in the graph.
+ * Deletes an edge between two nodes in the graph. Nodes that are not in the graph are left out of it.
  *
  * @param node1 The first node of the edge to be deleted.
  * @param node2 The second node of the edge to be deleted.
  *
  * @return void
  */
-template <typename vertex, typename edge>
-void Graph<vertex, edge>::delete_edge(vertex node1, vertex node2) {
-    typename Graph<vertex, edge>::set_iterator it1;
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::delete_edge(vertex node1, vertex node2) {
+    snapshot.reset();
+    typename Graph<vertex, edge, direction>::iterator it1 = network.find(node1);
+    typename Graph<vertex, edge, direction>::iterator it2 = network.find(node2);
+    if (it1 == network.end() || it2 == network.end())
+        return;
+
+    it1->second.erase(std::make_pair(node2, edge()));
+    if constexpr (direction == Direction::undirected) {
+        it2->second.erase(std::make_pair(node1, edge()));
+    } else if constexpr (direction == Direction::bidirectional) {
+        typename adjacency_map::iterator in = reverse.find(node2);
+        if (in != reverse.end())
+            in->second.erase(std::make_pair(node1, edge()));
+    }
+}
+
+/**
+ * Modifies the weight of the edge between two nodes in the graph, adding the edge if it does not exist.
+ * An existing edge keeps its place in both neighbor sets, only its weight changes.
+ *
+ * @param node1 The first node of the edge to be modified.
+ * @param node2 The second node of the edge to be modified.
+ * @param new_weight The new weight for the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::modify_edge(const vertex node1, const vertex node2, const edge new_weight) {
+    snapshot.reset();
+    typename Graph<vertex, edge, direction>::iterator it1 = network.find(node1);
+    typename Graph<vertex, edge, direction>::iterator it2 = network.find(node2);
+    if (it1 == network.end() || it2 == network.end()) {
+        add_edge(node1, node2, new_weight);
+        return;
+    }
 
-    // Find the set iterator at which node1 is connected to node2
-    it1 = isConnected(node1, node2);
-    if (it1 != network[node1].end()) {
-        network[node1].erase(it1);
+    set_iterator e1 = isConnected(it1->second, node2);
+    if (e1 == it1->second.end()) {
+        add_edge(node1, node2, new_weight);
+        return;
     }
 
-    // Find the set iterator at which node2 is connected to node1
-    it1 = isConnected(node2, node1);
-    if (it1 != network[node2].end()) {
-        network[node2].erase(it1);
+    reweight(it1->second, e1, new_weight);
+    if constexpr (direction == Direction::undirected) {
+        if (!(node1 == node2))
+            reweight(it2->second, isConnected(it2->second, node1), new_weight);
+    } else if constexpr (direction == Direction::bidirectional) {
+        std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &in = reverse.find(node2)->second;
+        reweight(in, isConnected(in, node1), new_weight);
     }
 }
 
 /**
- * Modifies an existing edge between two nodes in the graph by deleting the current edge and adding a new edge with updated weight.
+ * Changes the weight stored in a neighbor set entry.
+ * Set entries are immutable, so the entry is extracted, updated and put back next to its old
+ * neighbors, which the hint makes constant time.
  *
- * @param node1 The first node of the existing edge to be modified.
- * @param node2 The second node of the existing edge to be modified.
- * @param new_weight The new weight for the updated edge.
+ * @param neighbors The neighbor set holding the entry.
+ * @param it The entry to update.
+ * @param new_weight The new weight of the entry.
  *
  * @return void
  */
-template <typename vertex, typename edge>
-void Graph<vertex, edge>::modify_edge(const vertex node1, const vertex node2, const edge new_weight) {
-    delete_edge(node1, node2);
-    add_edge(node1, node2, new_weight);
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::reweight(std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &neighbors, set_iterator it, const edge &new_weight) {
+    set_iterator next = std::next(it);
+    typename std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>::node_type entry = neighbors.extract(it);
+    entry.value().second = new_weight;
+    neighbors.insert(next, std::move(entry));
+}
+
+/**
+ * Adds a batch of edges without logging them one by one. Both directions of every edge are sorted and grouped
+ * by vertex, so every vertex is looked up once and its neighbors are inserted in order with a hint.
+ * Directed graphs store the edges leaving every vertex the same way, and bidirectional ones repeat it for the
+ * edges entering every vertex.
+ * Like add_edge, an edge that is already in the graph or earlier in the batch keeps its weight,
+ * unless keep_minimum is set.
+ *
+ * @param first Iterator to the first edge, a tuple-like (vertex1, vertex2, weight) read with std::get.
+ * @param last Iterator past the last edge.
+ * @param keep_minimum Keep the smallest weight of repeated edges, including edges already in the graph.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename input_iterator>
+void Graph<vertex, edge, direction>::add_edges(input_iterator first, input_iterator last, bool keep_minimum) {
+    snapshot.reset();
+    std::vector<std::tuple<vertex, vertex, edge>> arcs;
+    size_type batch = 0;
+    for (; first != last; ++first, ++batch) {
+        const auto &e = *first;
+        arcs.emplace_back(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+        if (direction == Direction::undirected && !(std::get<0>(e) == std::get<1>(e)))
+            arcs.emplace_back(std::get<1>(e), std::get<0>(e), std::get<2>(e));
+    }
+    GRAPH_LOG("Adding " << batch << " edges");
+    GRAPH_COUNT(edges_added, batch);
+
+    insert_arcs(network, arcs, keep_minimum);
+    if constexpr (direction != Direction::undirected) {
+        for (const std::tuple<vertex, vertex, edge> &a : arcs)
+            network.try_emplace(std::get<1>(a));
+    }
+    if constexpr (direction == Direction::bidirectional) {
+        for (std::tuple<vertex, vertex, edge> &a : arcs)
+            std::swap(std::get<0>(a), std::get<1>(a));
+        insert_arcs(reverse, arcs, keep_minimum);
+    }
+}
+
+/**
+ * Inserts arcs into an adjacency map. The arcs are sorted by vertex and neighbour, so every vertex is
+ * looked up once and its neighbours are inserted in order with a hint.
+ *
+ * @param adjacency The map to insert into.
+ * @param arcs The (vertex, neighbour, weight) arcs, sorted in place.
+ * @param keep_minimum Keep the smallest weight of repeated arcs, including arcs already in the map.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::insert_arcs(adjacency_map &adjacency, std::vector<std::tuple<vertex, vertex, edge>> &arcs, bool keep_minimum) {
+    // Stable, so that without keep_minimum the first occurrence of an edge comes first in its group
+    std::stable_sort(arcs.begin(), arcs.end(), [](const std::tuple<vertex, vertex, edge> &lhs, const std::tuple<vertex, vertex, edge> &rhs) {
+        return std::get<0>(lhs) < std::get<0>(rhs) || (!(std::get<0>(rhs) < std::get<0>(lhs)) && std::get<1>(lhs) < std::get<1>(rhs));
+    });
+
+    size_type sources = 0;
+    for (size_type i = 0; i < arcs.size(); ++i)
+        sources += i == 0 || std::get<0>(arcs[i - 1]) < std::get<0>(arcs[i]);
+    adjacency.reserve(adjacency.size() + sources);
+
+    size_type i = 0;
+    while (i < arcs.size()) {
+        const vertex &u = std::get<0>(arcs[i]);
+        std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &neighbors = adjacency[u];
+        for (; i < arcs.size() && !(u < std::get<0>(arcs[i])); ++i) {
+            const vertex &v = std::get<1>(arcs[i]);
+            edge weight = std::get<2>(arcs[i]);
+            for (; i + 1 < arcs.size() && std::get<0>(arcs[i + 1]) == u && std::get<1>(arcs[i + 1]) == v; ++i) {
+                if (keep_minimum && std::get<2>(arcs[i + 1]) < weight)
+                    weight = std::get<2>(arcs[i + 1]);
+            }
+
+            set_iterator it = neighbors.emplace_hint(neighbors.end(), v, weight);
+            if (keep_minimum && weight < it->second)
+                reweight(neighbors, it, weight);
+        }
+    }
+}
+
+/**
+ * Checks if two nodes in the graph are connected by an edge, without adding either node to the graph.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ *
+ * @return true if the edge exists, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::has_edge(const vertex &node1, const vertex &node2) const {
+    typename std::pmr::unordered_map<vertex, std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>>>::const_iterator it = network.find(node1);
+    return it != network.end() && isConnected(it->second, node2) != it->second.end();
+}
+
+/**
+ * Returns the vertices with an edge leading to a node, read from the reverse index in O(degree) instead of
+ * scanning every vertex. Only available for undirected and bidirectional graphs.
+ *
+ * @param node The node whose incoming edges are wanted.
+ *
+ * @return The set of (predecessor, weight) pairs, empty if the node is not in the graph.
+ */
+template <typename vertex, typename edge, Direction direction>
+const std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> &Graph<vertex, edge, direction>::predecessors(const vertex &node) const {
+    static_assert(direction != Direction::directed, "predecessors() needs the reverse index of Direction::bidirectional");
+    static const std::pmr::set<std::pair<vertex, edge>, uniquePair<vertex, edge>> none;
+    const adjacency_map &incoming = direction == Direction::bidirectional ? reverse : network;
+    typename adjacency_map::const_iterator it = incoming.find(node);
+    return it == incoming.end() ? none : it->second;
 }
 
 /**
@@ -178,53 +627,337 @@ void Graph<vertex, edge>::modify_edge(const vertex node1, const vertex node2, co
  *
  * @return An iterator pointing to the node in the graph or the end iterator if no such node exists.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::iterator Graph<vertex, edge>::find(const vertex node) {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::iterator Graph<vertex, edge, direction>::find(const vertex node) {
+    snapshot.reset();
     return network.find(node);
 }
 
 /**
  * Finds the shortest path from the given source vertex to all other vertices in the graph using Dijkstra's algorithm.
  *
+ * Runs on a CsrGraph snapshot with an indexed heap. The snapshot is kept until the next call that can
+ * change the graph, so repeated searches on an unchanged graph freeze it only once.
+ *
  * @param src The source vertex from which to find the shortest path.
  *
  * @return A map of vertices to pairs containing the previous vertex and the weight of the shortest path.
  */
-template <typename vertex, typename edge>
-std::map<vertex, std::pair<vertex, edge>> Graph<vertex, edge>::dijkstra(const vertex &src) {
-    std::set<std::pair<vertex, edge>, weightedOrder<vertex, edge>> setds;
-    std::map<vertex, std::pair<vertex, edge>> path;
+template <typename vertex, typename edge, Direction direction>
+std::map<vertex, std::pair<vertex, edge>> Graph<vertex, edge, direction>::dijkstra(const vertex &src) {
+    if (!snapshot)
+        snapshot = std::make_shared<const CsrGraph<vertex, edge>>(freeze());
+    return snapshot->dijkstra(src);
+}
+
+/**
+ * Returns the vertices reachable from a vertex in breadth first order, found lazily as the range is read,
+ * so stopping early saves the rest of the traversal. Empty if the vertex is not part of the graph.
+ *
+ * @param src The vertex to start from.
+ *
+ * @return A single pass range of vertices ending with traversalEnd.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::breadth_first_search_range Graph<vertex, edge, direction>::bfs(const vertex &src) {
+    snapshot.reset();
+    return breadth_first_search_range(*this, src);
+}
+
+/**
+ * Returns the vertices reachable from a vertex in depth first order, found lazily as the range is read.
+ * Empty if the vertex is not part of the graph.
+ *
+ * @param src The vertex to start from.
+ *
+ * @return A single pass range of vertices ending with traversalEnd.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::depth_first_search_range Graph<vertex, edge, direction>::dfs(const vertex &src) {
+    snapshot.reset();
+    return depth_first_search_range(*this, src);
+}
+
+/**
+ * Returns the vertices reachable from a vertex with their distances in order of distance, settling one
+ * vertex per step of Dijkstra's algorithm on the adjacency map. Unlike dijkstra(), which freezes the whole
+ * graph after every change, reading the k nearest vertices only costs the edges of those k.
+ *
+ * @param src The vertex to start from.
+ *
+ * @return A single pass range of (vertex, distance) pairs ending with traversalEnd.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::dijkstra_range Graph<vertex, edge, direction>::dijkstra_settled(const vertex &src) const {
+    return dijkstra_range(*this, src);
+}
 
-    for (Graph<vertex, edge>::list_type x : network)
-        path[x.first].second = INF;
+/**
+ * Finds the k vertices closest to a vertex within a distance, the source included, by reading
+ * dijkstra_settled() until the k-th vertex or the first one further away. Every call builds its own
+ * hash map and queue, sized by the vertices it reaches rather than the graph; to reuse scratch buffers
+ * between queries, run them on a snapshot with ShortestPathEngine::run_nearest or CsrGraph::nearest.
+ *
+ * @param src The vertex to start from.
+ * @param k The largest number of vertices to report.
+ * @param max_distance The largest distance to report vertices at.
+ *
+ * @return (vertex, distance) pairs in order of distance.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::vector<std::pair<vertex, edge>> Graph<vertex, edge, direction>::nearest(const vertex &src, size_type k, const edge &max_distance) const {
+    std::vector<std::pair<vertex, edge>> found;
+    if (k == 0)
+        return found;
+    for (const std::pair<vertex, edge> &x : dijkstra_settled(src)) {
+        if (max_distance < x.second)
+            break;
+        found.push_back(x);
+        if (found.size() == k)
+            break;
+    }
+    return found;
+}
 
-    setds.insert(std::make_pair(src, edge()));
+/**
+ * Finds every vertex within a distance of a vertex, the source included, by reading dijkstra_settled()
+ * until the first vertex further away. Like nearest(), every call allocates its own search state.
+ *
+ * @param src The vertex to start from.
+ * @param max_distance The largest distance to report vertices at.
+ *
+ * @return (vertex, distance) pairs in order of distance.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::vector<std::pair<vertex, edge>> Graph<vertex, edge, direction>::within(const vertex &src, const edge &max_distance) const {
+    return nearest(src, SIZE_MAX, max_distance);
+}
+
+/**
+ * Pops the vertex with the smallest estimated total distance off the queue and relaxes its edges.
+ * Stale queue entries left behind by earlier relaxations are skipped.
+ *
+ * @param adjacency The edges to follow, network or, searching backwards, the reverse index.
+ * @param q The queue of (vertex, distance + heuristic estimate) pairs.
+ * @param path Map of reached vertices to pairs of the previous vertex and the tentative distance.
+ * @param top Receives the settled vertex and its distance.
+ * @param h The heuristic estimating the remaining distance from a vertex to the goal.
+ * @param goal The vertex the search is heading to.
+ *
+ * @return true if a vertex was settled, false if the queue ran empty.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename heuristic>
+bool Graph<vertex, edge, direction>::settle(const adjacency_map &adjacency, min_queue &q, std::unordered_map<vertex, std::pair<vertex, edge>> &path,
+                                            std::pair<vertex, edge> &top, heuristic &h, const vertex &goal) const {
+    while (!q.empty()) {
+        top = q.top();
+        q.pop();
+        GRAPH_COUNT(heap_operations, 1);
+        edge distance = path[top.first].second;
+        if (distance + h(top.first, goal) < top.second)
+            continue;
+        top.second = distance;
+        GRAPH_COUNT(vertices_visited, 1);
+
+        typename adjacency_map::const_iterator it = adjacency.find(top.first);
+        if (it != adjacency.end()) {
+            GRAPH_COUNT(relaxations, it->second.size());
+            for (const std::pair<vertex, edge> &x : it->second) {
+                edge weight = distance + x.second;
+                typename std::unordered_map<vertex, std::pair<vertex, edge>>::iterator p = path.find(x.first);
+                if (p == path.end() || weight < p->second.second) {
+                    path[x.first] = std::make_pair(top.first, weight);
+                    q.push(std::make_pair(x.first, weight + h(x.first, goal)));
+                    GRAPH_COUNT(heap_operations, 1);
+                }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Finds the shortest path between two vertices with A* search, expanding vertices in order of their
+ * distance from src plus the heuristic estimate of their distance to dst.
+ * The heuristic must never overestimate, e.g. the straight line distance on geographic graphs.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param h Callable h(node, dst) returning a lower bound of the distance from node to dst.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename heuristic>
+std::pair<edge, std::vector<vertex>> Graph<vertex, edge, direction>::astar(const vertex &src, const vertex &dst, heuristic h) const {
+    std::pair<edge, std::vector<vertex>> result(INF, std::vector<vertex>());
+    if (network.find(src) == network.end() || network.find(dst) == network.end())
+        return result;
+
+    std::unordered_map<vertex, std::pair<vertex, edge>> path;
+    min_queue q;
     path[src] = std::make_pair(src, edge());
+    q.push(std::make_pair(src, h(src, dst)));
 
-    std::pair<vertex, edge> tmp;
-    vertex u, v;
-    edge weight;
+    std::pair<vertex, edge> top;
+    bool found = false;
+    while (!found && settle(network, q, path, top, h, dst))
+        found = top.first == dst;
+    if (!found)
+        return result;
 
-    while (!setds.empty()) {
-        tmp = *(setds.begin());
-        setds.erase(setds.begin());
-        u = tmp.first;
+    result.first = top.second;
+    for (vertex u = dst; !(u == src); u = path[u].first)
+        result.second.push_back(u);
+    result.second.push_back(src);
+    std::reverse(result.second.begin(), result.second.end());
+    return result;
+}
 
-        for (typename Graph<vertex, edge>::set_iterator i = network[u].begin(); i != network[u].end(); ++i) {
-            v = (*i).first;
-            weight = (*i).second;
+/**
+ * Finds the shortest path between two vertices, stopping as soon as the destination is settled
+ * instead of exploring the whole graph like dijkstra.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param bidirectional Search from both ends at once and stop when the two searches meet. Directed graphs
+ *                      without the reverse index of Direction::bidirectional search from src only.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::pair<edge, std::vector<vertex>> Graph<vertex, edge, direction>::shortest_path(const vertex &src, const vertex &dst, bool bidirectional) const {
+    std::pair<edge, std::vector<vertex>> result(INF, std::vector<vertex>());
+    if (network.find(src) == network.end() || network.find(dst) == network.end())
+        return result;
 
-            if (path[v].second > path[u].second + weight) {
-                if (path[v].second != INF)
-                    setds.erase(setds.find(std::make_pair(v, path[v].second)));
+    if (!bidirectional || src == dst || direction == Direction::directed)
+        return astar(src, dst, zeroHeuristic<edge>());
 
-                path[v].second = path[u].second + weight;
-                path[v].first = u;
-                setds.insert(std::make_pair(v, path[v].second));
+    std::unordered_map<vertex, std::pair<vertex, edge>> forward, backward;
+    min_queue qf, qb;
+    forward[src] = std::make_pair(src, edge());
+    qf.push(std::make_pair(src, edge()));
+    backward[dst] = std::make_pair(dst, edge());
+    qb.push(std::make_pair(dst, edge()));
+
+    zeroHeuristic<edge> h;
+    std::pair<vertex, edge> top;
+    vertex meet = src;
+
+    // Undirected edges let the backward search reuse the forward adjacency, directed ones follow the reverse index
+    const adjacency_map &incoming = direction == Direction::bidirectional ? reverse : network;
+    while (!qf.empty() && !qb.empty() && qf.top().second + qb.top().second < result.first) {
+        bool is_forward = !(qb.top().second < qf.top().second);
+        const adjacency_map &adjacency = is_forward ? network : incoming;
+        std::unordered_map<vertex, std::pair<vertex, edge>> &side = is_forward ? forward : backward;
+        std::unordered_map<vertex, std::pair<vertex, edge>> &other = is_forward ? backward : forward;
+        if (!settle(adjacency, is_forward ? qf : qb, side, top, h, is_forward ? dst : src))
+            break;
+
+        // Every neighbour reached by both searches is a candidate meeting point
+        typename adjacency_map::const_iterator it = adjacency.find(top.first);
+        if (it == adjacency.end())
+            continue;
+        for (const std::pair<vertex, edge> &x : it->second) {
+            typename std::unordered_map<vertex, std::pair<vertex, edge>>::iterator o = other.find(x.first);
+            if (o != other.end() && side[x.first].second + o->second.second < result.first) {
+                result.first = side[x.first].second + o->second.second;
+                meet = x.first;
             }
         }
     }
-    return path;
+    if (result.first == edge(INF))
+        return result;
+
+    for (vertex u = meet; !(u == src); u = forward[u].first)
+        result.second.push_back(u);
+    result.second.push_back(src);
+    std::reverse(result.second.begin(), result.second.end());
+    for (vertex u = meet; !(u == dst); u = backward[u].first)
+        result.second.push_back(backward[u].first);
+    return result;
+}
+
+/**
+ * Finds a minimum spanning forest of the graph, one tree per connected component, on a snapshot.
+ *
+ * @param threads 1 for Kruskal's algorithm, otherwise the number of threads running Borůvka's algorithm,
+ *                0 for one per hardware thread.
+ *
+ * @return A pair of the total weight and the (vertex1, vertex2, weight) tree edges.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::pair<edge, std::vector<std::tuple<vertex, vertex, edge>>> Graph<vertex, edge, direction>::minimum_spanning_tree(unsigned threads) const {
+    static_assert(direction == Direction::undirected, "spanning trees are defined on undirected graphs");
+    CsrGraph<vertex, edge> snapshot = freeze();
+    SpanningTree<edge> tree = threads == 1 ? snapshot.minimum_spanning_tree() : snapshot.parallel_minimum_spanning_tree(threads);
+
+    std::pair<edge, std::vector<std::tuple<vertex, vertex, edge>>> result(tree.weight, std::vector<std::tuple<vertex, vertex, edge>>());
+    result.second.reserve(tree.edges.size());
+    for (const std::tuple<uint32_t, uint32_t, edge> &e : tree.edges)
+        result.second.emplace_back(snapshot.vertex_at(std::get<0>(e)), snapshot.vertex_at(std::get<1>(e)), std::get<2>(e));
+    return result;
+}
+
+/**
+ * Copies per dense id values of a snapshot into a map keyed by vertex.
+ *
+ * @param snapshot The snapshot the values were computed on.
+ * @param values One value per dense id of the snapshot.
+ *
+ * @return A map of every vertex to its value.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::map<vertex, double> Graph<vertex, edge, direction>::by_vertex(const CsrGraph<vertex, edge> &snapshot, const std::vector<double> &values) {
+    std::map<vertex, double> result;
+    for (size_type u = 0; u < values.size(); ++u)
+        result.emplace(snapshot.vertex_at(static_cast<uint32_t>(u)), values[u]);
+    return result;
+}
+
+/**
+ * Ranks the vertices of the graph with PageRank on a snapshot, following edges in their direction.
+ *
+ * @param damping The probability of following an edge rather than jumping to a random vertex.
+ * @param tolerance Stop once the ranks change by less than this in total within a round.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return A map of every vertex to its rank, the ranks summing up to 1.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::map<vertex, double> Graph<vertex, edge, direction>::page_rank(double damping, double tolerance, unsigned threads) const {
+    CsrGraph<vertex, edge> snapshot = freeze();
+    return by_vertex(snapshot, snapshot.page_rank(damping, tolerance, 100, threads));
+}
+
+/**
+ * Computes the degree centrality of every vertex, its number of neighbours as a fraction of all other vertices.
+ *
+ * @return A map of every vertex to its centrality.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::map<vertex, double> Graph<vertex, edge, direction>::degree_centrality() const {
+    CsrGraph<vertex, edge> snapshot = freeze();
+    return by_vertex(snapshot, snapshot.degree_centrality());
+}
+
+/**
+ * Computes the betweenness centrality of every vertex with Brandes' algorithm on a snapshot.
+ *
+ * @param weighted Measure paths by their edge weights, which must be positive, instead of their number of edges.
+ * @param threads The number of threads, 0 for one per hardware thread.
+ *
+ * @return A map of every vertex to the number of shortest paths between other vertices passing through it.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::map<vertex, double> Graph<vertex, edge, direction>::betweenness_centrality(bool weighted, unsigned threads) const {
+    CsrGraph<vertex, edge> snapshot = freeze();
+    return by_vertex(snapshot, snapshot.betweenness_centrality(weighted, threads));
 }
 
 /**
@@ -232,8 +965,8 @@ std::map<vertex, std::pair<vertex, edge>> Graph<vertex, edge>::dijkstra(const ve
  *
  * @return The size of the graph, i.e., the number of vertices.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::size_type Graph<vertex, edge>::size() const {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::size_type Graph<vertex, edge, direction>::size() const {
     return network.size();
 }
 
@@ -242,18 +975,43 @@ typename Graph<vertex, edge>::size_type Graph<vertex, edge>::size() const {
  *
  * @return true if the graph is empty, false otherwise.
  */
-template <typename vertex, typename edge>
-bool Graph<vertex, edge>::empty() const {
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::empty() const {
     return network.empty();
 }
 
+/**
+ * Builds an immutable compressed sparse row snapshot of the graph.
+ * Vertices are interned to dense integer ids, so read-heavy workloads can run on flat arrays.
+ * Snapshots of directed graphs also index the edges entering every vertex.
+ *
+ * @return A CsrGraph holding the current vertices and edges.
+ */
+template <typename vertex, typename edge, Direction direction>
+CsrGraph<vertex, edge> Graph<vertex, edge, direction>::freeze() const {
+    return CsrGraph<vertex, edge>(network, direction != Direction::undirected);
+}
+
+/**
+ * Writes a snapshot of the graph to a binary file, which CsrGraph::load maps back into memory.
+ *
+ * @param path The file to write.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::save(const std::string &path) const {
+    freeze().save(path);
+}
+
 /**
  * Returns an iterator pointing to the beginning of the graph.
  *
  * @return An iterator pointing to the beginning of the graph.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::iterator Graph<vertex, edge>::begin() {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::iterator Graph<vertex, edge, direction>::begin() {
+    snapshot.reset();
     return network.begin();
 }
 
@@ -262,8 +1020,9 @@ typename Graph<vertex, edge>::iterator Graph<vertex, edge>::begin() {
  *
  * @return An iterator pointing to the past-the-end element in the graph.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::iterator Graph<vertex, edge>::end() {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::iterator Graph<vertex, edge, direction>::end() {
+    snapshot.reset();
     return network.end();
 }
 
@@ -272,9 +1031,9 @@ typename Graph<vertex, edge>::iterator Graph<vertex, edge>::end() {
  *
  * @return void
  */
-template <typename vertex, typename edge>
-void Graph<vertex, edge>::display() {
-    for (Graph<vertex, edge>::list_type x : network) {
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::display() {
+    for (Graph<vertex, edge, direction>::list_type x : network) {
         std::cout << x.first << " : ";
         for (std::pair<vertex, edge> y : x.second) {
             std::cout << '<' << y.first << ',' << y.second << '>' << ", ";
@@ -283,19 +1042,139 @@ void Graph<vertex, edge>::display() {
     }
 }
 
+/**
+ * Constructs an empty traversal context.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::traversal_context::traversal_context() : epoch(0), count(0), head(0) {}
+
+/**
+ * Begins a new traversal in constant time by moving to the next epoch instead of clearing the visited set.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::traversal_context::start() {
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    count = 0;
+    frontier.clear();
+    head = 0;
+}
+
+/**
+ * Doubles the visited table, keeping the vertices of the current traversal.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::traversal_context::grow() {
+    std::vector<vertex> old_keys(std::max<size_t>(16, keys.size() * 2));
+    std::vector<unsigned> old_stamp(old_keys.size(), 0);
+    old_keys.swap(keys);
+    old_stamp.swap(stamp);
+    for (size_t i = 0; i < old_keys.size(); ++i) {
+        if (old_stamp[i] == epoch) {
+            size_t j = slot(old_keys[i]);
+            keys[j] = old_keys[i];
+            stamp[j] = epoch;
+        }
+    }
+}
+
+/**
+ * Finds the slot holding a vertex in the current traversal, or the free slot where it belongs.
+ *
+ * @param node The vertex to look up.
+ *
+ * @return An index into the visited table.
+ */
+template <typename vertex, typename edge, Direction direction>
+size_t Graph<vertex, edge, direction>::traversal_context::slot(const vertex &node) const {
+    size_t mask = keys.size() - 1;
+    size_t i = std::hash<vertex>()(node) & mask;
+    while (stamp[i] == epoch && !(keys[i] == node))
+        i = (i + 1) & mask;
+    return i;
+}
+
+/**
+ * Marks a vertex as visited by the current traversal.
+ *
+ * @param node The vertex to mark.
+ *
+ * @return true if the vertex was not visited yet, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::traversal_context::visit(const vertex &node) {
+    if ((count + 1) * 2 > keys.size())
+        grow();
+    size_t i = slot(node);
+    if (stamp[i] == epoch)
+        return false;
+    keys[i] = node;
+    stamp[i] = epoch;
+    ++count;
+    GRAPH_COUNT(vertices_visited, 1);
+    return true;
+}
+
+/**
+ * Checks if a vertex was visited by the current traversal.
+ *
+ * @param node The vertex to check.
+ *
+ * @return true if the vertex was visited, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::traversal_context::visited(const vertex &node) const {
+    return !keys.empty() && stamp[slot(node)] == epoch;
+}
+
 /**
  * Constructor for the breadth first search iterator.
+ * The iterator and its copies share a traversal context of their own.
  *
  * @param obj_ The graph object reference.
  * @param it_ The iterator to the start node.
  *
  * @return None
  */
-template <typename vertex, typename edge>
-Graph<vertex, edge>::breadth_first_search_iterator::breadth_first_search_iterator(Graph<vertex, edge> &obj_, Graph<vertex, edge>::iterator it_)
-    : obj(obj_), it(it_) {
-    visited[it->first] = true;
-    q.push(it);
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::breadth_first_search_iterator::breadth_first_search_iterator(Graph<vertex, edge, direction> &obj_, Graph<vertex, edge, direction>::iterator it_)
+    : owned(std::make_shared<traversal_context>()), ctx(owned.get()), obj(obj_), it(it_) {
+    start();
+}
+
+/**
+ * Constructor for the breadth first search iterator reusing a traversal context.
+ * Starting the traversal takes constant time; the context must not be used by another traversal meanwhile.
+ *
+ * @param obj_ The graph object reference.
+ * @param it_ The iterator to the start node.
+ * @param ctx_ The traversal context to reuse.
+ *
+ * @return None
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::breadth_first_search_iterator::breadth_first_search_iterator(Graph<vertex, edge, direction> &obj_, Graph<vertex, edge, direction>::iterator it_,
+                                                                                  traversal_context &ctx_)
+    : ctx(&ctx_), obj(obj_), it(it_) {
+    start();
+}
+
+/**
+ * Marks the start node as visited and queues it.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::breadth_first_search_iterator::start() {
+    ctx->start();
+    ctx->visit(it->first);
+    ctx->frontier.push_back(it);
 }
 
 /**
@@ -303,20 +1182,18 @@ Graph<vertex, edge>::breadth_first_search_iterator::breadth_first_search_iterato
  *
  * @return Returns a breadth_first_search_iterator object.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::breadth_first_search_iterator &Graph<vertex, edge>::breadth_first_search_iterator::operator++() {
-    if (!q.empty()) {
-        Graph<vertex, edge>::set_iterator begin = q.front()->second.begin();
-        Graph<vertex, edge>::set_iterator end = q.front()->second.end();
-        q.pop();
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::breadth_first_search_iterator &Graph<vertex, edge, direction>::breadth_first_search_iterator::operator++() {
+    if (ctx->head < ctx->frontier.size()) {
+        Graph<vertex, edge, direction>::set_iterator begin = ctx->frontier[ctx->head]->second.begin();
+        Graph<vertex, edge, direction>::set_iterator end = ctx->frontier[ctx->head]->second.end();
+        ++ctx->head;
         while (begin != end) {
-            if (!visited[begin->first]) {
-                visited[begin->first] = true;
-                q.push(obj.find(begin->first));
-            }
+            if (ctx->visit(begin->first))
+                ctx->frontier.push_back(obj.find(begin->first));
             ++begin;
         }
-        it = q.front();
+        it = ctx->head < ctx->frontier.size() ? ctx->frontier[ctx->head] : obj.end();
     }
     return *this;
 }
@@ -328,8 +1205,8 @@ typename Graph<vertex, edge>::breadth_first_search_iterator &Graph<vertex, edge>
  *
  * @return Returns a breadth_first_search_iterator object.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::breadth_first_search_iterator Graph<vertex, edge>::breadth_first_search_iterator::operator++(int) {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::breadth_first_search_iterator Graph<vertex, edge, direction>::breadth_first_search_iterator::operator++(int) {
     breadth_first_search_iterator tmp(*this);
     ++(*this);
     return tmp;
@@ -340,13 +1217,13 @@ typename Graph<vertex, edge>::breadth_first_search_iterator Graph<vertex, edge>:
  *
  * @return Reference to the current vertex.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::list_type &Graph<vertex, edge>::breadth_first_search_iterator::operator*() {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::list_type &Graph<vertex, edge, direction>::breadth_first_search_iterator::operator*() {
     return *it;
 }
 
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::iterator Graph<vertex, edge>::breadth_first_search_iterator::operator->() {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::iterator Graph<vertex, edge, direction>::breadth_first_search_iterator::operator->() {
     return it;
 }
 
@@ -357,8 +1234,8 @@ typename Graph<vertex, edge>::iterator Graph<vertex, edge>::breadth_first_search
  *
  * @return Returns true if the iterators are equal, false otherwise.
  */
-template <typename vertex, typename edge>
-bool Graph<vertex, edge>::breadth_first_search_iterator::operator==(const breadth_first_search_iterator &rhs) const {
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::breadth_first_search_iterator::operator==(const breadth_first_search_iterator &rhs) const {
     return it == rhs.it;
 }
 
@@ -369,8 +1246,8 @@ bool Graph<vertex, edge>::breadth_first_search_iterator::operator==(const breadt
  *
  * @return Returns true if the iterators are inequal, false otherwise.
  */
-template <typename vertex, typename edge>
-bool Graph<vertex, edge>::breadth_first_search_iterator::operator!=(const breadth_first_search_iterator &rhs) const {
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::breadth_first_search_iterator::operator!=(const breadth_first_search_iterator &rhs) const {
     return !(*this == rhs);
 }
 
@@ -379,27 +1256,58 @@ bool Graph<vertex, edge>::breadth_first_search_iterator::operator!=(const breadt
  *
  * @return true if the iterator has reached the end, false otherwise.
  */
-template <typename vertex, typename edge>
-bool Graph<vertex, edge>::breadth_first_search_iterator::bfsend() {
-    return q.empty();
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::breadth_first_search_iterator::bfsend() {
+    return ctx->head == ctx->frontier.size();
 }
 
 /**
  * @brief Constructor for initializing the depth first search iterator.
+ * The iterator and its copies share a traversal context of their own.
  *
  * @param obj_ Reference to the graph object.
  * @param it_ Iterator to the start node.
  */
-template <typename vertex, typename edge>
-Graph<vertex, edge>::depth_first_search_iterator::depth_first_search_iterator(Graph<vertex, edge> &obj_, Graph<vertex, edge>::iterator it_)
-    : obj(obj_), it(it_) {
-    visited[it->first] = true;
-    Graph<vertex, edge>::set_iterator begin = it->second.begin();
-    Graph<vertex, edge>::set_iterator end = it->second.end();
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::depth_first_search_iterator::depth_first_search_iterator(Graph<vertex, edge, direction> &obj_, Graph<vertex, edge, direction>::iterator it_)
+    : owned(std::make_shared<traversal_context>()), ctx(owned.get()), obj(obj_), it(it_) {
+    start();
+}
+
+/**
+ * @brief Constructor for initializing the depth first search iterator reusing a traversal context.
+ * Starting the traversal takes constant time; the context must not be used by another traversal meanwhile.
+ *
+ * @param obj_ Reference to the graph object.
+ * @param it_ Iterator to the start node.
+ * @param ctx_ The traversal context to reuse.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::depth_first_search_iterator::depth_first_search_iterator(Graph<vertex, edge, direction> &obj_, Graph<vertex, edge, direction>::iterator it_,
+                                                                              traversal_context &ctx_)
+    : ctx(&ctx_), obj(obj_), it(it_) {
+    start();
+}
+
+/**
+ * @brief Marks the start node as visited and pushes its neighbours on the stack.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::depth_first_search_iterator::start() {
+    ctx->start();
+    ctx->visit(it->first);
+    Graph<vertex, edge, direction>::set_iterator begin = it->second.begin();
+    Graph<vertex, edge, direction>::set_iterator end = it->second.end();
     while (begin != end) {
-        st.push(obj.find(begin->first));
+        ctx->frontier.push_back(obj.find(begin->first));
         ++begin;
     }
+
+    // Like operator++, keep the start node on the stack so that dfsend() turns true only after it was read
+    if (ctx->frontier.empty())
+        ctx->frontier.push_back(it);
 }
 
 /**
@@ -407,24 +1315,25 @@ Graph<vertex, edge>::depth_first_search_iterator::depth_first_search_iterator(Gr
  *
  * @return Reference to the updated iterator.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::depth_first_search_iterator &Graph<vertex, edge>::depth_first_search_iterator::operator++() {
-    while (!st.empty() && visited[st.top()->first])
-        st.pop();
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::depth_first_search_iterator &Graph<vertex, edge, direction>::depth_first_search_iterator::operator++() {
+    std::vector<Graph<vertex, edge, direction>::iterator> &st = ctx->frontier;
+    while (!st.empty() && ctx->visited(st.back()->first))
+        st.pop_back();
 
     if (!st.empty()) {
-        it = st.top();
-        st.pop();
-        visited[it->first] = true;
-        Graph<vertex, edge>::set_iterator begin = it->second.begin();
-        Graph<vertex, edge>::set_iterator end = it->second.end();
+        it = st.back();
+        st.pop_back();
+        ctx->visit(it->first);
+        Graph<vertex, edge, direction>::set_iterator begin = it->second.begin();
+        Graph<vertex, edge, direction>::set_iterator end = it->second.end();
         while (begin != end) {
-            if (!visited[begin->first])
-                st.push(obj.find(begin->first));
+            if (!ctx->visited(begin->first))
+                st.push_back(obj.find(begin->first));
             ++begin;
         }
         if (st.empty())
-            st.push(it);
+            st.push_back(it);
     }
     return *this;
 }
@@ -435,8 +1344,8 @@ typename Graph<vertex, edge>::depth_first_search_iterator &Graph<vertex, edge>::
  * @param int Dummy parameter to differentiate from prefix increment.
  * @return A copy of the iterator before increment.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::depth_first_search_iterator Graph<vertex, edge>::depth_first_search_iterator::operator++(int) {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::depth_first_search_iterator Graph<vertex, edge, direction>::depth_first_search_iterator::operator++(int) {
     depth_first_search_iterator temp(*this);
     ++(*this);
     return temp;
@@ -447,8 +1356,8 @@ typename Graph<vertex, edge>::depth_first_search_iterator Graph<vertex, edge>::d
  *
  * @return Reference to the current vertex.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::list_type &Graph<vertex, edge>::depth_first_search_iterator::operator*() {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::list_type &Graph<vertex, edge, direction>::depth_first_search_iterator::operator*() {
     return *it;
 }
 
@@ -457,8 +1366,8 @@ typename Graph<vertex, edge>::list_type &Graph<vertex, edge>::depth_first_search
  *
  * @return The current iterator.
  */
-template <typename vertex, typename edge>
-typename Graph<vertex, edge>::iterator Graph<vertex, edge>::depth_first_search_iterator::operator->() {
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::iterator Graph<vertex, edge, direction>::depth_first_search_iterator::operator->() {
     return it;
 }
 
@@ -468,8 +1377,8 @@ typename Graph<vertex, edge>::iterator Graph<vertex, edge>::depth_first_search_i
  * @param rhs The iterator to compare with.
  * @return true if equal, false otherwise.
  */
-template <typename vertex, typename edge>
-bool Graph<vertex, edge>::depth_first_search_iterator::operator==(const depth_first_search_iterator &rhs) const {
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::depth_first_search_iterator::operator==(const depth_first_search_iterator &rhs) const {
     return it == rhs.it;
 }
 
@@ -479,8 +1388,8 @@ bool Graph<vertex, edge>::depth_first_search_iterator::operator==(const depth_fi
  * @param rhs The iterator to compare with.
  * @return true if not equal, false otherwise.
  */
-template <typename vertex, typename edge>
-bool Graph<vertex, edge>::depth_first_search_iterator::operator!=(const depth_first_search_iterator &rhs) const {
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::depth_first_search_iterator::operator!=(const depth_first_search_iterator &rhs) const {
     return !(*this == rhs);
 }
 
@@ -489,7 +1398,290 @@ bool Graph<vertex, edge>::depth_first_search_iterator::operator!=(const depth_fi
  *
  * @return true if the iterator has reached the end, false otherwise.
  */
-template <typename vertex, typename edge>
-bool Graph<vertex, edge>::depth_first_search_iterator::dfsend() {
-    return st.empty();
-}
\ No newline at end of file
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::depth_first_search_iterator::dfsend() {
+    return ctx->frontier.empty();
+}
+
+/**
+ * Constructs an iterator reading a lazy traversal range.
+ *
+ * @param owner_ The range holding the traversal.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename range, typename value>
+Graph<vertex, edge, direction>::traversal_iterator<range, value>::traversal_iterator(range *owner_) : owner(owner_) {}
+
+/**
+ * Returns the element the traversal is at.
+ *
+ * @return Reference to the current element, valid until the traversal advances.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename range, typename value>
+typename Graph<vertex, edge, direction>::template traversal_iterator<range, value>::reference Graph<vertex, edge, direction>::traversal_iterator<range, value>::operator*() const {
+    return owner->current();
+}
+
+/**
+ * Returns the address of the element the traversal is at.
+ *
+ * @return Pointer to the current element, valid until the traversal advances.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename range, typename value>
+typename Graph<vertex, edge, direction>::template traversal_iterator<range, value>::pointer Graph<vertex, edge, direction>::traversal_iterator<range, value>::operator->() const {
+    return &owner->current();
+}
+
+/**
+ * Advances the traversal to its next element.
+ *
+ * @return Reference to the iterator.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename range, typename value>
+typename Graph<vertex, edge, direction>::template traversal_iterator<range, value> &Graph<vertex, edge, direction>::traversal_iterator<range, value>::operator++() {
+    owner->advance();
+    return *this;
+}
+
+/**
+ * Advances the traversal to its next element. The traversal is single pass, so no copy is returned.
+ *
+ * @param int Dummy parameter to differentiate from prefix increment.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename range, typename value>
+void Graph<vertex, edge, direction>::traversal_iterator<range, value>::operator++(int) {
+    owner->advance();
+}
+
+/**
+ * Checks if the traversal of the range is over.
+ *
+ * @return true if there are no more elements, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename range, typename value>
+bool Graph<vertex, edge, direction>::traversal_iterator<range, value>::at_end() const {
+    return owner->finished();
+}
+
+/**
+ * Starts a breadth first traversal; the graph must not change while the range is in use.
+ *
+ * @param obj_ The graph to traverse.
+ * @param src The vertex to start from.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::breadth_first_search_range::breadth_first_search_range(Graph<vertex, edge, direction> &obj_, const vertex &src) {
+    typename Graph<vertex, edge, direction>::iterator it = obj_.find(src);
+    if (it != obj_.end())
+        walk.reset(new breadth_first_search_iterator(obj_, it));
+}
+
+/**
+ * Returns the vertex the traversal is at.
+ *
+ * @return The current vertex.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &Graph<vertex, edge, direction>::breadth_first_search_range::current() const {
+    return (*walk)->first;
+}
+
+/**
+ * Moves on to the next vertex in breadth first order, queueing the neighbours of the current one.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::breadth_first_search_range::advance() {
+    ++*walk;
+}
+
+/**
+ * Checks if every reachable vertex has been read.
+ *
+ * @return true if the traversal is over, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::breadth_first_search_range::finished() const {
+    return !walk || walk->bfsend();
+}
+
+/**
+ * Returns an iterator at the vertex the traversal is at. The range is single pass, every iterator
+ * advances the same traversal.
+ *
+ * @return The iterator.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::breadth_first_search_range::iterator Graph<vertex, edge, direction>::breadth_first_search_range::begin() {
+    return iterator(this);
+}
+
+/**
+ * Returns the sentinel that iterators compare equal to once the traversal is over.
+ *
+ * @return The sentinel.
+ */
+template <typename vertex, typename edge, Direction direction>
+traversalEnd Graph<vertex, edge, direction>::breadth_first_search_range::end() const {
+    return traversalEnd();
+}
+
+/**
+ * Starts a depth first traversal; the graph must not change while the range is in use.
+ *
+ * @param obj_ The graph to traverse.
+ * @param src The vertex to start from.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::depth_first_search_range::depth_first_search_range(Graph<vertex, edge, direction> &obj_, const vertex &src) {
+    typename Graph<vertex, edge, direction>::iterator it = obj_.find(src);
+    if (it != obj_.end())
+        walk.reset(new depth_first_search_iterator(obj_, it));
+}
+
+/**
+ * Returns the vertex the traversal is at.
+ *
+ * @return The current vertex.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &Graph<vertex, edge, direction>::depth_first_search_range::current() const {
+    return (*walk)->first;
+}
+
+/**
+ * Moves on to the next vertex in depth first order.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::depth_first_search_range::advance() {
+    ++*walk;
+}
+
+/**
+ * Checks if every reachable vertex has been read.
+ *
+ * @return true if the traversal is over, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::depth_first_search_range::finished() const {
+    return !walk || walk->dfsend();
+}
+
+/**
+ * Returns an iterator at the vertex the traversal is at. The range is single pass, every iterator
+ * advances the same traversal.
+ *
+ * @return The iterator.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::depth_first_search_range::iterator Graph<vertex, edge, direction>::depth_first_search_range::begin() {
+    return iterator(this);
+}
+
+/**
+ * Returns the sentinel that iterators compare equal to once the traversal is over.
+ *
+ * @return The sentinel.
+ */
+template <typename vertex, typename edge, Direction direction>
+traversalEnd Graph<vertex, edge, direction>::depth_first_search_range::end() const {
+    return traversalEnd();
+}
+
+/**
+ * Starts Dijkstra's algorithm and settles the source; the graph must not change while the range is in use.
+ *
+ * @param obj_ The graph to search.
+ * @param source The vertex to start from.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<vertex, edge, direction>::dijkstra_range::dijkstra_range(const Graph<vertex, edge, direction> &obj_, const vertex &source)
+    : obj(&obj_), src(source), done(true) {
+    if (obj->network.find(src) == obj->network.end())
+        return;
+    path[src] = std::make_pair(src, edge());
+    q.push(std::make_pair(src, edge()));
+    advance();
+}
+
+/**
+ * Returns the vertex settled last and its distance from the source.
+ *
+ * @return The current (vertex, distance) pair.
+ */
+template <typename vertex, typename edge, Direction direction>
+const std::pair<vertex, edge> &Graph<vertex, edge, direction>::dijkstra_range::current() const {
+    return top;
+}
+
+/**
+ * Settles the next closest vertex, relaxing its out-edges.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void Graph<vertex, edge, direction>::dijkstra_range::advance() {
+    zeroHeuristic<edge> h;
+    done = !obj->settle(obj->network, q, path, top, h, src);
+}
+
+/**
+ * Checks if every reachable vertex has been settled and read.
+ *
+ * @return true if the search is over, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool Graph<vertex, edge, direction>::dijkstra_range::finished() const {
+    return done;
+}
+
+/**
+ * Returns an iterator at the vertex settled last. The range is single pass, every iterator advances the same search.
+ *
+ * @return The iterator.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename Graph<vertex, edge, direction>::dijkstra_range::iterator Graph<vertex, edge, direction>::dijkstra_range::begin() {
+    return iterator(this);
+}
+
+/**
+ * Returns the sentinel that iterators compare equal to once the search is over.
+ *
+ * @return The sentinel.
+ */
+template <typename vertex, typename edge, Direction direction>
+traversalEnd Graph<vertex, edge, direction>::dijkstra_range::end() const {
+    return traversalEnd();
+}
+
+/**
+ * Returns the previous vertex on the shortest path to a settled vertex.
+ *
+ * @param node A vertex the range has already yielded.
+ *
+ * @return The parent of the vertex, the source for itself.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &Graph<vertex, edge, direction>::dijkstra_range::parent(const vertex &node) const {
+    return path.at(node).first;
+}
+
+#include "csr_graph.h"
+#include "shortest_path.h"
+#include "interned_graph.h"
+#include "graph_reader.h"
+#include "arena.h"
+#include "multi_graph.h"
+#include "concurrent_graph.h"
+#include "dynamic_shortest_path.h"
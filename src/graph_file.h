@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "interner.h"
+
+// Fixed size header at the start of a graph file written by CsrGraph::save.
+// Section offsets count bytes from the start of the file and are multiples of 64.
+struct GraphFileHeader {
+    // "CSRGRAPH"
+    char magic[8];
+    uint32_t version;
+
+    // 0x01020304 as stored by the machine that wrote the file, files are only read with the same byte order
+    uint32_t byte_order;
+
+    // sizeof(vertex), or 0 for vertices stored in a string table
+    uint32_t vertex_size;
+    uint32_t edge_size;
+
+    uint64_t vertices;
+    uint64_t entries;
+    uint64_t vertex_table;
+    uint64_t offset_table;
+    uint64_t target_table;
+    uint64_t weight_table;
+    uint64_t file_size;
+
+    // Version 2 onwards, zero when reading a version 1 file
+    uint64_t flags;
+
+    // In-edge arrays of directed snapshots, holding as many entries as the out-edge arrays
+    uint64_t in_offset_table;
+    uint64_t in_target_table;
+    uint64_t in_weight_table;
+};
+
+static constexpr uint32_t graph_file_version = 2;
+
+// Size of the header of version 1 files, which end before flags
+static constexpr size_t graph_file_v1_header = offsetof(GraphFileHeader, flags);
+
+// GraphFileHeader::flags
+static constexpr uint64_t graph_file_directed = 1;
+
+// Read-only memory mapping of a whole file, unmapped when destroyed
+class MappedFile {
+private:
+    const char *bytes;
+    size_t length;
+
+public:
+    explicit MappedFile(const std::string &);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const;
+    size_t size() const;
+};
+
+/**
+ * Maps a file into memory. Pages are read from disk when first touched.
+ *
+ * @param path The file to map.
+ */
+inline MappedFile::MappedFile(const std::string &path) : bytes(nullptr), length(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void *p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path);
+        }
+        bytes = static_cast<const char *>(p);
+    }
+    ::close(fd);
+}
+
+/**
+ * Unmaps the file.
+ */
+inline MappedFile::~MappedFile() {
+    if (bytes)
+        ::munmap(const_cast<char *>(bytes), length);
+}
+
+/**
+ * Returns the mapped bytes.
+ *
+ * @return Pointer to the first byte of the file.
+ */
+inline const char *MappedFile::data() const {
+    return bytes;
+}
+
+/**
+ * Returns the length of the file.
+ *
+ * @return The number of mapped bytes.
+ */
+inline size_t MappedFile::size() const {
+    return length;
+}
+
+/**
+ * Pads a stream with zeros up to the next multiple of 64 bytes, so the following section can be
+ * read in place with any alignment.
+ *
+ * @param out The stream to pad.
+ *
+ * @return The offset of the next section.
+ */
+inline uint64_t graph_file_align(std::ostream &out) {
+    static const char zeros[64] = {};
+    uint64_t position = static_cast<uint64_t>(out.tellp());
+    uint64_t padding = (64 - position % 64) % 64;
+    out.write(zeros, static_cast<std::streamsize>(padding));
+    return position + padding;
+}
+
+// Stores the vertex table of a graph file as the raw bytes of every vertex
+template <typename vertex>
+struct GraphFileVertices {
+    static_assert(std::is_trivially_copyable<vertex>::value, "graph files store vertices as raw bytes or, for std::string, in a string table");
+
+    static constexpr uint32_t vertex_size = sizeof(vertex);
+
+    static void write(std::ostream &out, const VertexInterner<vertex> &names) {
+        for (typename VertexInterner<vertex>::id_type u = 0; u < names.size(); ++u)
+            out.write(reinterpret_cast<const char *>(&names.vertex_at(u)), sizeof(vertex));
+    }
+
+    static void read(const char *first, const char *last, uint64_t n, VertexInterner<vertex> &names) {
+        if (static_cast<uint64_t>(last - first) < n * sizeof(vertex))
+            throw std::runtime_error("truncated vertex table");
+        names.reserve(n);
+        for (uint64_t u = 0; u < n; ++u) {
+            vertex node;
+            std::memcpy(&node, first + u * sizeof(vertex), sizeof(vertex));
+            names.intern(node);
+        }
+    }
+};
+
+// Stores the vertex table of a graph file as n + 1 offsets into the concatenated characters of every string
+template <>
+struct GraphFileVertices<std::string> {
+    static constexpr uint32_t vertex_size = 0;
+
+    static void write(std::ostream &out, const VertexInterner<std::string> &names) {
+        uint64_t offset = 0;
+        out.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+        for (VertexInterner<std::string>::id_type u = 0; u < names.size(); ++u) {
+            offset += names.vertex_at(u).size();
+            out.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+        }
+        for (VertexInterner<std::string>::id_type u = 0; u < names.size(); ++u)
+            out.write(names.vertex_at(u).data(), static_cast<std::streamsize>(names.vertex_at(u).size()));
+    }
+
+    static void read(const char *first, const char *last, uint64_t n, VertexInterner<std::string> &names) {
+        if (static_cast<uint64_t>(last - first) < (n + 1) * sizeof(uint64_t))
+            throw std::runtime_error("truncated vertex table");
+        std::vector<uint64_t> offsets(n + 1);
+        std::memcpy(offsets.data(), first, offsets.size() * sizeof(uint64_t));
+        const char *characters = first + offsets.size() * sizeof(uint64_t);
+        if (offsets.back() > static_cast<uint64_t>(last - characters))
+            throw std::runtime_error("truncated vertex table");
+        names.reserve(n);
+        for (uint64_t u = 0; u < n; ++u) {
+            if (offsets[u + 1] < offsets[u])
+                throw std::runtime_error("corrupt vertex table");
+            names.intern(std::string(characters + offsets[u], offsets[u + 1] - offsets[u]));
+        }
+    }
+};
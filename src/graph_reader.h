@@ -0,0 +1,429 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "graph.h"
+#include "thread_pool.h"
+
+// Text formats understood by GraphReader
+enum class GraphFormat {
+    // One edge per line, "u v" or "u v weight", lines starting with '#' or '%' are comments
+    edge_list,
+
+    // DIMACS shortest path format (.gr), "p sp n m" then "a u v weight" arcs, lines starting with 'c' are comments
+    dimacs,
+
+    // Matrix Market coordinate format (.mtx), a banner, '%' comments, "rows columns entries", then "i j [value]"
+    matrix_market
+};
+
+template <typename vertex = int, // GraphReader::vertex_type
+          typename edge = double // GraphReader::edge_type
+          >
+class GraphReader {
+public:
+    typedef vertex vertex_type;
+    typedef edge edge_type;
+    typedef std::tuple<vertex, vertex, edge> value_type;
+    typedef size_t size_type;
+
+private:
+    static_assert(std::is_integral<vertex>::value, "GraphReader reads integer vertex ids");
+    static_assert(std::is_arithmetic<edge>::value, "GraphReader reads numeric weights");
+
+    std::string path;
+    std::unique_ptr<FILE, int (*)(FILE *)> file;
+    GraphFormat format;
+
+    // Bytes read but not parsed yet are buffer[head, tail)
+    std::vector<char> buffer;
+    size_type head;
+    size_type tail;
+    bool eof;
+
+    // Matrix Market file without values, every weight is 1
+    bool pattern;
+
+    // Symmetric Matrix Market file storing one triangle, entries off the diagonal stand for both arcs;
+    // skew-symmetric mirrors negate the weight
+    bool symmetric;
+    bool skew;
+
+    // Sizes announced by the header, 0 if the format has none
+    size_type declared_vertices;
+    size_type declared_edges;
+
+    // Parses a block on several threads, one output vector per thread
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<std::vector<value_type>> parts;
+
+    void fill();
+    void read_header();
+    void parse(const char *, const char *, std::vector<value_type> &) const;
+    void parse_line(const char *, const char *, std::vector<value_type> &) const;
+    [[noreturn]] void malformed(const char *, const char *) const;
+
+public:
+    explicit GraphReader(const std::string &, GraphFormat = GraphFormat::edge_list, unsigned = 1, size_type = size_type(1) << 24);
+
+    bool next(std::vector<value_type> &);
+    size_type vertices() const;
+    size_type edges() const;
+};
+
+/**
+ * Skips blanks inside a line.
+ *
+ * @param p The first character to look at.
+ * @param last The end of the line.
+ *
+ * @return The first character that is not a space, tab or carriage return.
+ */
+inline const char *graph_reader_skip(const char *p, const char *last) {
+    while (p < last && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+    return p;
+}
+
+/**
+ * Parses a number after optional blanks with std::from_chars.
+ *
+ * @param p The first character to look at.
+ * @param last The end of the line.
+ * @param x Receives the number.
+ *
+ * @return The character after the number, or nullptr if there is no number.
+ */
+template <typename number>
+const char *graph_reader_number(const char *p, const char *last, number &x) {
+    p = graph_reader_skip(p, last);
+    std::from_chars_result r = std::from_chars(p, last, x);
+    return r.ec == std::errc() ? r.ptr : nullptr;
+}
+
+/**
+ * Opens a file and reads its header, if the format has one.
+ *
+ * @param path_ The file to read.
+ * @param format_ The format of the file.
+ * @param threads The number of threads parsing every block, 0 for one per hardware thread.
+ * @param block The number of bytes read and parsed at once.
+ */
+template <typename vertex, typename edge>
+GraphReader<vertex, edge>::GraphReader(const std::string &path_, GraphFormat format_, unsigned threads, size_type block)
+    : path(path_), file(std::fopen(path_.c_str(), "rb"), &std::fclose), format(format_), buffer(std::max<size_type>(block, 4096)), head(0),
+      tail(0), eof(false), pattern(false), symmetric(false), skew(false), declared_vertices(0), declared_edges(0) {
+    if (!file)
+        throw std::runtime_error("cannot open " + path);
+    if (threads != 1) {
+        pool.reset(new ThreadPool(threads));
+        parts.resize(pool->size());
+    }
+    fill();
+    read_header();
+}
+
+/**
+ * Moves the unparsed bytes to the front of the buffer and reads as many new bytes as fit,
+ * doubling the buffer if it is full.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void GraphReader<vertex, edge>::fill() {
+    if (eof)
+        return;
+    std::memmove(buffer.data(), buffer.data() + head, tail - head);
+    tail -= head;
+    head = 0;
+    if (tail == buffer.size())
+        buffer.resize(buffer.size() * 2);
+    size_type n = std::fread(buffer.data() + tail, 1, buffer.size() - tail, file.get());
+    tail += n;
+    if (n == 0)
+        eof = true;
+}
+
+/**
+ * Consumes the header lines of DIMACS and Matrix Market files, stopping at the first edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void GraphReader<vertex, edge>::read_header() {
+    if (format == GraphFormat::edge_list)
+        return;
+
+    bool banner = false;
+    while (true) {
+        const char *first = buffer.data() + head;
+        const char *newline = static_cast<const char *>(std::memchr(first, '\n', tail - head));
+        if (!newline && !eof) {
+            fill();
+            continue;
+        }
+        const char *last = newline ? newline : buffer.data() + tail;
+        const char *p = graph_reader_skip(first, last);
+        if (p == last && !newline) {
+            if (format == GraphFormat::matrix_market && !banner)
+                throw std::runtime_error(path + " is not a Matrix Market coordinate file");
+            if (format == GraphFormat::matrix_market)
+                throw std::runtime_error(path + " has no Matrix Market size line");
+            return;
+        }
+
+        if (format == GraphFormat::dimacs) {
+            if (p < last && *p == 'p') {
+                unsigned long long n = 0, m = 0;
+                p = graph_reader_skip(p + 1, last);
+                while (p < last && *p != ' ' && *p != '\t')
+                    ++p;
+                if (!(p = graph_reader_number(p, last, n)) || !(p = graph_reader_number(p, last, m)))
+                    malformed(first, last);
+                declared_vertices = n;
+                declared_edges = m;
+            } else if (p < last && *p != 'c') {
+                return;
+            }
+        } else if (!banner) {
+            // %%MatrixMarket matrix coordinate <real|integer|pattern|complex> <general|symmetric|skew-symmetric|hermitian>,
+            // the fields are case-insensitive
+            std::vector<std::string> fields;
+            for (const char *q = p; q < last;) {
+                const char *end = q;
+                while (end < last && *end != ' ' && *end != '\t' && *end != '\r')
+                    ++end;
+                fields.emplace_back(q, end);
+                std::transform(fields.back().begin(), fields.back().end(), fields.back().begin(),
+                               [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+                q = graph_reader_skip(end, last);
+            }
+            if (fields.size() != 5 || fields[0] != "%%matrixmarket" || fields[1] != "matrix" || fields[2] != "coordinate")
+                throw std::runtime_error(path + " is not a Matrix Market coordinate file");
+            if (fields[3] == "complex" || fields[4] == "hermitian")
+                throw std::runtime_error(path + " holds complex values");
+            if (fields[3] != "real" && fields[3] != "integer" && fields[3] != "pattern")
+                throw std::runtime_error(path + ": unknown Matrix Market field \"" + fields[3] + "\"");
+            if (fields[4] != "general" && fields[4] != "symmetric" && fields[4] != "skew-symmetric")
+                throw std::runtime_error(path + ": unknown Matrix Market symmetry \"" + fields[4] + "\"");
+            if (fields[4] == "skew-symmetric" && !std::is_signed<edge>::value)
+                throw std::runtime_error(path + " is skew-symmetric, which needs a signed edge type");
+            pattern = fields[3] == "pattern";
+            symmetric = fields[4] != "general";
+            skew = fields[4] == "skew-symmetric";
+            banner = true;
+        } else if (p < last && *p != '%') {
+            unsigned long long rows = 0, columns = 0, entries = 0;
+            if (!(p = graph_reader_number(p, last, rows)) || !(p = graph_reader_number(p, last, columns)) ||
+                !(p = graph_reader_number(p, last, entries)))
+                malformed(first, last);
+            declared_vertices = std::max(rows, columns);
+            declared_edges = entries;
+            head = newline ? newline - buffer.data() + 1 : tail;
+            return;
+        }
+        head = newline ? newline - buffer.data() + 1 : tail;
+    }
+}
+
+/**
+ * Reads the next block of the file and parses the complete lines in it.
+ *
+ * @param chunk Cleared, then receives the edges of the block in file order.
+ *
+ * @return false once the whole file has been parsed, true otherwise.
+ */
+template <typename vertex, typename edge>
+bool GraphReader<vertex, edge>::next(std::vector<value_type> &chunk) {
+    chunk.clear();
+    fill();
+    if (head == tail)
+        return false;
+
+    // Parse up to the last complete line, unless the file ends without a newline
+    const char *first = buffer.data() + head;
+    const char *last = buffer.data() + tail;
+    while (!eof && std::find(first, last, '\n') == last) {
+        fill();
+        first = buffer.data() + head;
+        last = buffer.data() + tail;
+    }
+    if (!eof) {
+        while (last[-1] != '\n')
+            --last;
+    }
+    head = last - buffer.data();
+
+    if (!pool || last - first < 65536) {
+        parse(first, last, chunk);
+        return true;
+    }
+
+    // Split at line boundaries, one piece per thread
+    std::vector<const char *> bounds(parts.size() + 1, last);
+    bounds[0] = first;
+    for (size_type k = 1; k < parts.size(); ++k) {
+        const char *p = std::max(bounds[k - 1], first + (last - first) * k / parts.size());
+        p = std::find(p, last, '\n');
+        bounds[k] = p == last ? last : p + 1;
+    }
+    pool->run([&](unsigned t) {
+        parts[t].clear();
+        parse(bounds[t], bounds[t + 1], parts[t]);
+    });
+    size_type total = 0;
+    for (const std::vector<value_type> &part : parts)
+        total += part.size();
+    chunk.reserve(total);
+    for (const std::vector<value_type> &part : parts)
+        chunk.insert(chunk.end(), part.begin(), part.end());
+    return true;
+}
+
+/**
+ * Parses every line of a range of complete lines.
+ *
+ * @param first The first character of the range.
+ * @param last The end of the range.
+ * @param out Receives the edges.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void GraphReader<vertex, edge>::parse(const char *first, const char *last, std::vector<value_type> &out) const {
+    while (first < last) {
+        const char *newline = static_cast<const char *>(std::memchr(first, '\n', last - first));
+        const char *end = newline ? newline : last;
+        parse_line(first, end, out);
+        first = end + 1;
+    }
+}
+
+/**
+ * Parses one line, skipping blank lines and comments.
+ *
+ * @param first The first character of the line.
+ * @param last The end of the line, without the newline.
+ * @param out Receives the edge on the line, if any, followed by its mirror for off-diagonal entries of
+ *            symmetric Matrix Market files.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void GraphReader<vertex, edge>::parse_line(const char *first, const char *last, std::vector<value_type> &out) const {
+    const char *p = graph_reader_skip(first, last);
+    if (p == last)
+        return;
+
+    if (format == GraphFormat::dimacs) {
+        if (*p == 'c' || *p == 'p')
+            return;
+        if (*p != 'a')
+            malformed(first, last);
+        ++p;
+    } else if (*p == '%' || (format == GraphFormat::edge_list && *p == '#')) {
+        return;
+    }
+
+    vertex u, v;
+    edge w = 1;
+    if (!(p = graph_reader_number(p, last, u)) || !(p = graph_reader_number(p, last, v)))
+        malformed(first, last);
+    p = graph_reader_skip(p, last);
+    if (p < last && !pattern) {
+        // Edge lists may carry further columns, e.g. timestamps, after the weight
+        if (!(p = graph_reader_number(p, last, w)) || (format != GraphFormat::edge_list && graph_reader_skip(p, last) != last))
+            malformed(first, last);
+    } else if (format == GraphFormat::dimacs || (format == GraphFormat::matrix_market && !pattern)) {
+        malformed(first, last);
+    }
+    out.emplace_back(u, v, w);
+    if (symmetric && u != v)
+        out.emplace_back(v, u, skew ? edge(0) - w : w);
+}
+
+/**
+ * Reports a line that does not match the format of the file.
+ *
+ * @param first The first character of the line.
+ * @param last The end of the line.
+ *
+ * @return Never returns, throws std::runtime_error.
+ */
+template <typename vertex, typename edge>
+void GraphReader<vertex, edge>::malformed(const char *first, const char *last) const {
+    throw std::runtime_error(path + ": malformed line \"" + std::string(first, last) + "\"");
+}
+
+/**
+ * Returns the number of vertices announced by the header.
+ *
+ * @return The vertex count of the "p" line or Matrix Market size line, 0 for plain edge lists.
+ */
+template <typename vertex, typename edge>
+typename GraphReader<vertex, edge>::size_type GraphReader<vertex, edge>::vertices() const {
+    return declared_vertices;
+}
+
+/**
+ * Returns the number of edges announced by the header.
+ *
+ * @return The arc count of the "p" line or the entry count of the Matrix Market size line, 0 for plain edge lists.
+ *         Symmetric Matrix Market files count stored entries, not the mirrored arcs.
+ */
+template <typename vertex, typename edge>
+typename GraphReader<vertex, edge>::size_type GraphReader<vertex, edge>::edges() const {
+    return declared_edges;
+}
+
+/**
+ * Loads a file into a graph block by block with Graph::add_edges.
+ *
+ * @param path The file to read.
+ * @param graph The graph receiving the edges.
+ * @param format The format of the file.
+ * @param threads The number of threads parsing every block, 0 for one per hardware thread.
+ * @param keep_minimum Keep the smallest weight of repeated edges.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void read_graph(const std::string &path, Graph<vertex, edge, direction> &graph, GraphFormat format = GraphFormat::edge_list, unsigned threads = 1,
+                bool keep_minimum = false) {
+    GraphReader<vertex, edge> reader(path, format, threads);
+    std::vector<std::tuple<vertex, vertex, edge>> chunk;
+    while (reader.next(chunk))
+        graph.add_edges(chunk.begin(), chunk.end(), keep_minimum);
+}
+
+/**
+ * Loads a file straight into a snapshot.
+ *
+ * @param path The file to read.
+ * @param format The format of the file.
+ * @param threads The number of threads parsing every block, 0 for one per hardware thread.
+ * @param keep_minimum Keep the smallest weight of repeated edges.
+ * @param directed Edges lead from the first to the second vertex of every line.
+ *
+ * @return A snapshot of the edges in the file.
+ */
+template <typename vertex, typename edge>
+CsrGraph<vertex, edge> read_snapshot(const std::string &path, GraphFormat format = GraphFormat::edge_list, unsigned threads = 1,
+                                     bool keep_minimum = false, bool directed = false) {
+    GraphReader<vertex, edge> reader(path, format, threads);
+    std::vector<std::tuple<vertex, vertex, edge>> edges, chunk;
+    edges.reserve(reader.edges());
+    while (reader.next(chunk))
+        edges.insert(edges.end(), chunk.begin(), chunk.end());
+    return CsrGraph<vertex, edge>(edges.begin(), edges.end(), keep_minimum, directed);
+}
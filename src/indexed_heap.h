@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "instrumentation.h"
+
+template <typename key,          // IndexedHeap::key_type
+          unsigned arity = 4     // children per heap node
+          >
+class IndexedHeap {
+public:
+    typedef key key_type;
+    typedef uint32_t id_type;
+    typedef size_t size_type;
+
+    // Position of ids that are not in the heap
+    static constexpr id_type npos = UINT32_MAX;
+
+private:
+    // Heap ordered array of (key, id) entries, ties broken by id
+    std::vector<std::pair<key, id_type>> heap;
+
+    // Id -> index of its entry in heap, or npos
+    std::vector<id_type> position;
+
+    void sift_up(size_type);
+    void sift_down(size_type);
+    void place(size_type, const std::pair<key, id_type> &);
+
+public:
+    explicit IndexedHeap(size_type = 0);
+
+    void resize(size_type);
+    size_type size() const;
+    bool empty() const;
+    bool contains(id_type) const;
+
+    void push(id_type, const key &);
+    void decrease(id_type, const key &);
+    bool push_or_decrease(id_type, const key &);
+    id_type top() const;
+    const key &top_key() const;
+    void pop();
+    void clear();
+};
+
+/**
+ * Constructs a heap able to hold the ids 0 .. n - 1.
+ *
+ * @param n The number of distinct ids.
+ */
+template <typename key, unsigned arity>
+IndexedHeap<key, arity>::IndexedHeap(size_type n) : position(n, npos) {}
+
+/**
+ * Grows or shrinks the id range of the heap. The heap must be empty.
+ *
+ * @param n The new number of distinct ids.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::resize(size_type n) {
+    position.assign(n, npos);
+}
+
+/**
+ * Returns the number of ids in the heap.
+ *
+ * @return The size of the heap.
+ */
+template <typename key, unsigned arity>
+typename IndexedHeap<key, arity>::size_type IndexedHeap<key, arity>::size() const {
+    return heap.size();
+}
+
+/**
+ * Checks if the heap is empty.
+ *
+ * @return true if the heap is empty, false otherwise.
+ */
+template <typename key, unsigned arity>
+bool IndexedHeap<key, arity>::empty() const {
+    return heap.empty();
+}
+
+/**
+ * Checks if an id is currently in the heap.
+ *
+ * @param id The id to check.
+ *
+ * @return true if the id is in the heap, false otherwise.
+ */
+template <typename key, unsigned arity>
+bool IndexedHeap<key, arity>::contains(id_type id) const {
+    return position[id] != npos;
+}
+
+/**
+ * Inserts an id that is not in the heap yet.
+ *
+ * @param id The id to insert.
+ * @param k The key of the id.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::push(id_type id, const key &k) {
+    GRAPH_COUNT(heap_operations, 1);
+    heap.emplace_back(k, id);
+    position[id] = static_cast<id_type>(heap.size() - 1);
+    sift_up(heap.size() - 1);
+}
+
+/**
+ * Lowers the key of an id that is in the heap, moving its entry in place.
+ *
+ * @param id The id to update.
+ * @param k The new key, not greater than the current one.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::decrease(id_type id, const key &k) {
+    GRAPH_COUNT(heap_operations, 1);
+    heap[position[id]].first = k;
+    sift_up(position[id]);
+}
+
+/**
+ * Inserts an id, or lowers its key if it is already in the heap and k is smaller.
+ *
+ * @param id The id to insert or update.
+ * @param k The key of the id.
+ *
+ * @return true if the heap changed, false otherwise.
+ */
+template <typename key, unsigned arity>
+bool IndexedHeap<key, arity>::push_or_decrease(id_type id, const key &k) {
+    if (position[id] == npos) {
+        push(id, k);
+        return true;
+    }
+    if (k < heap[position[id]].first) {
+        decrease(id, k);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the id with the smallest key.
+ *
+ * @return The id at the top of the heap.
+ */
+template <typename key, unsigned arity>
+typename IndexedHeap<key, arity>::id_type IndexedHeap<key, arity>::top() const {
+    return heap.front().second;
+}
+
+/**
+ * Returns the smallest key in the heap.
+ *
+ * @return The key at the top of the heap.
+ */
+template <typename key, unsigned arity>
+const key &IndexedHeap<key, arity>::top_key() const {
+    return heap.front().first;
+}
+
+/**
+ * Removes the id with the smallest key.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::pop() {
+    GRAPH_COUNT(heap_operations, 1);
+    position[heap.front().second] = npos;
+    if (heap.size() > 1) {
+        place(0, heap.back());
+        heap.pop_back();
+        sift_down(0);
+    } else {
+        heap.pop_back();
+    }
+}
+
+/**
+ * Removes every id, in time proportional to the current size of the heap.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::clear() {
+    for (const std::pair<key, id_type> &x : heap)
+        position[x.second] = npos;
+    heap.clear();
+}
+
+/**
+ * Stores an entry at a heap index and records its position.
+ *
+ * @param i The heap index.
+ * @param x The entry to store.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::place(size_type i, const std::pair<key, id_type> &x) {
+    heap[i] = x;
+    position[x.second] = static_cast<id_type>(i);
+}
+
+/**
+ * Moves the entry at index i towards the root until its parent is not larger.
+ *
+ * @param i The heap index to start from.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::sift_up(size_type i) {
+    std::pair<key, id_type> x = heap[i];
+    while (i > 0) {
+        size_type parent = (i - 1) / arity;
+        if (!(x < heap[parent]))
+            break;
+        place(i, heap[parent]);
+        i = parent;
+    }
+    place(i, x);
+}
+
+/**
+ * Moves the entry at index i towards the leaves until no child is smaller.
+ *
+ * @param i The heap index to start from.
+ *
+ * @return void
+ */
+template <typename key, unsigned arity>
+void IndexedHeap<key, arity>::sift_down(size_type i) {
+    std::pair<key, id_type> x = heap[i];
+    size_type n = heap.size();
+    while (true) {
+        size_type first = i * arity + 1;
+        if (first >= n)
+            break;
+        size_type last = first + arity < n ? first + arity : n;
+        size_type best = first;
+        for (size_type c = first + 1; c < last; ++c) {
+            if (heap[c] < heap[best])
+                best = c;
+        }
+        if (!(heap[best] < x))
+            break;
+        place(i, heap[best]);
+        i = best;
+    }
+    place(i, x);
+}
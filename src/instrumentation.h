@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+// Compile-time switches, define them to 1 before including graph.h (or with -DGRAPH_LOGGING=1) to enable.
+// Every translation unit of a program must use the same values.
+#ifndef GRAPH_LOGGING
+#define GRAPH_LOGGING 0
+#endif
+
+#ifndef GRAPH_STATS
+#define GRAPH_STATS 0
+#endif
+
+// Counters fed by the graph algorithms when GRAPH_STATS is enabled
+struct GraphStats {
+    std::atomic<uint64_t> edges_added;
+    std::atomic<uint64_t> relaxations;
+    std::atomic<uint64_t> heap_operations;
+    std::atomic<uint64_t> vertices_visited;
+
+    GraphStats();
+    void reset();
+};
+
+/**
+ * Constructs a set of counters, all zero.
+ */
+inline GraphStats::GraphStats() {
+    reset();
+}
+
+/**
+ * Sets every counter back to zero.
+ *
+ * @return void
+ */
+inline void GraphStats::reset() {
+    edges_added.store(0, std::memory_order_relaxed);
+    relaxations.store(0, std::memory_order_relaxed);
+    heap_operations.store(0, std::memory_order_relaxed);
+    vertices_visited.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the counters shared by every graph of the program.
+ *
+ * @return The process wide counters.
+ */
+inline GraphStats &graph_stats() {
+    static GraphStats stats;
+    return stats;
+}
+
+// Writes a line to std::cout when GRAPH_LOGGING is enabled, compiles to nothing otherwise
+#define GRAPH_LOG(message)                  \
+    do {                                    \
+        if constexpr (GRAPH_LOGGING)        \
+            std::cout << message << '\n';   \
+    } while (0)
+
+// Adds n to a GraphStats counter when GRAPH_STATS is enabled, compiles to nothing otherwise
+#define GRAPH_COUNT(counter, n)                                                      \
+    do {                                                                             \
+        if constexpr (GRAPH_STATS)                                                   \
+            graph_stats().counter.fetch_add((n), std::memory_order_relaxed);         \
+    } while (0)
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "interner.h"
+#include "union_find.h"
+
+template <typename vertex = int,                         // InternedGraph::vertex_type
+          typename edge = double,                        // InternedGraph::edge_type
+          Direction direction = Direction::undirected    // InternedGraph::orientation
+          >
+class InternedGraph {
+public:
+    typedef vertex vertex_type;
+    typedef edge edge_type;
+    typedef typename VertexInterner<vertex>::id_type id_type;
+    typedef size_t size_type;
+
+    // Returned by id() for vertices that were never added
+    static constexpr id_type npos = VertexInterner<vertex>::npos;
+
+private:
+    // Every vertex is stored once here, adjacency refers to it by id
+    VertexInterner<vertex> names;
+    Graph<id_type, edge, direction> network;
+
+    // Connected components joined as edges are added; deleting edges can split components, which a
+    // union-find cannot undo, so it is rebuilt on the next query instead
+    UnionFind components;
+    bool stale;
+
+    void link(id_type, id_type);
+    void rebuild();
+
+public:
+    InternedGraph();
+
+    void add_edge(const vertex &, const vertex &, const edge = edge_type());
+    void delete_edge(const vertex &, const vertex &);
+    void modify_edge(const vertex &, const vertex &, const edge = edge_type());
+    bool has_edge(const vertex &, const vertex &) const;
+    template <typename input_iterator>
+    void add_edges(input_iterator, input_iterator, bool = false);
+    std::map<vertex, std::pair<vertex, edge>> dijkstra(const vertex &);
+    std::pair<edge, std::vector<vertex>> shortest_path(const vertex &, const vertex &, bool = false) const;
+    size_type size() const;
+    bool empty() const;
+    bool connected(const vertex &, const vertex &);
+    size_type component_count();
+
+    id_type id(const vertex &) const;
+    const vertex &vertex_at(id_type) const;
+    Graph<id_type, edge, direction> &graph();
+    const Graph<id_type, edge, direction> &graph() const;
+};
+
+/**
+ * Constructs an empty graph.
+ */
+template <typename vertex, typename edge, Direction direction>
+InternedGraph<vertex, edge, direction>::InternedGraph() : stale(false) {}
+
+/**
+ * Joins the components of the endpoints of a new edge, unless they are rebuilt on the next query anyway.
+ *
+ * @param u The id of the first node of the edge.
+ * @param v The id of the second node of the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void InternedGraph<vertex, edge, direction>::link(id_type u, id_type v) {
+    if (stale)
+        return;
+    components.resize(names.size());
+    components.unite(u, v);
+}
+
+/**
+ * Recomputes the components from every edge of the graph.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void InternedGraph<vertex, edge, direction>::rebuild() {
+    components.clear();
+    components.resize(names.size());
+    for (const typename Graph<id_type, edge, direction>::list_type &x : network) {
+        for (const std::pair<id_type, edge> &y : x.second)
+            components.unite(x.first, y.first);
+    }
+    stale = false;
+}
+
+/**
+ * Adds an edge between two vertices, interning vertices that are new to the graph.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ * @param weight The weight of the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void InternedGraph<vertex, edge, direction>::add_edge(const vertex &node1, const vertex &node2, const edge weight) {
+    id_type u = names.intern(node1);
+    id_type v = names.intern(node2);
+    network.add_edge(u, v, weight);
+    link(u, v);
+}
+
+/**
+ * Adds a batch of edges, interning new vertices, with Graph::add_edges on their ids.
+ *
+ * @param first Iterator to the first edge, a tuple-like (vertex1, vertex2, weight) read with std::get.
+ * @param last Iterator past the last edge.
+ * @param keep_minimum Keep the smallest weight of repeated edges, including edges already in the graph.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename input_iterator>
+void InternedGraph<vertex, edge, direction>::add_edges(input_iterator first, input_iterator last, bool keep_minimum) {
+    std::vector<std::tuple<id_type, id_type, edge>> batch;
+    for (; first != last; ++first) {
+        const auto &e = *first;
+        id_type u = names.intern(std::get<0>(e));
+        id_type v = names.intern(std::get<1>(e));
+        batch.emplace_back(u, v, std::get<2>(e));
+    }
+    network.add_edges(batch.begin(), batch.end(), keep_minimum);
+    for (const std::tuple<id_type, id_type, edge> &e : batch)
+        link(std::get<0>(e), std::get<1>(e));
+}
+
+/**
+ * Deletes an edge between two vertices. Unknown vertices are ignored.
+ *
+ * @param node1 The first node of the edge to be deleted.
+ * @param node2 The second node of the edge to be deleted.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void InternedGraph<vertex, edge, direction>::delete_edge(const vertex &node1, const vertex &node2) {
+    id_type u = names.id(node1), v = names.id(node2);
+    if (u != npos && v != npos && network.has_edge(u, v)) {
+        network.delete_edge(u, v);
+        stale = true;
+    }
+}
+
+/**
+ * Modifies the weight of the edge between two vertices, adding it if it does not exist.
+ *
+ * @param node1 The first node of the edge to be modified.
+ * @param node2 The second node of the edge to be modified.
+ * @param new_weight The new weight for the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void InternedGraph<vertex, edge, direction>::modify_edge(const vertex &node1, const vertex &node2, const edge new_weight) {
+    id_type u = names.intern(node1);
+    id_type v = names.intern(node2);
+    network.modify_edge(u, v, new_weight);
+    link(u, v);
+}
+
+/**
+ * Checks if two vertices are connected by an edge, without interning either of them.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ *
+ * @return true if the edge exists, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool InternedGraph<vertex, edge, direction>::has_edge(const vertex &node1, const vertex &node2) const {
+    id_type u = names.id(node1), v = names.id(node2);
+    return u != npos && v != npos && network.has_edge(u, v);
+}
+
+/**
+ * Finds the shortest path from the given source vertex to all other vertices using Dijkstra's algorithm
+ * on the interned ids.
+ *
+ * @param src The source vertex from which to find the shortest path.
+ *
+ * @return A map of vertices to pairs containing the previous vertex and the weight of the shortest path.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::map<vertex, std::pair<vertex, edge>> InternedGraph<vertex, edge, direction>::dijkstra(const vertex &src) {
+    std::map<vertex, std::pair<vertex, edge>> path;
+    id_type s = names.id(src);
+    if (s == npos) {
+        for (const typename Graph<id_type, edge, direction>::list_type &x : network)
+            path[names.vertex_at(x.first)].second = INF;
+        path[src] = std::make_pair(src, edge());
+        return path;
+    }
+
+    for (const std::pair<const id_type, std::pair<id_type, edge>> &x : network.dijkstra(s)) {
+        std::pair<vertex, edge> &p = path[names.vertex_at(x.first)];
+        if (x.second.second != edge(INF))
+            p.first = names.vertex_at(x.second.first);
+        p.second = x.second.second;
+    }
+    return path;
+}
+
+/**
+ * Finds the shortest path between two vertices, stopping as soon as the destination is settled.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param bidirectional Search from both ends at once and stop when the two searches meet.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::pair<edge, std::vector<vertex>> InternedGraph<vertex, edge, direction>::shortest_path(const vertex &src, const vertex &dst, bool bidirectional) const {
+    std::pair<edge, std::vector<vertex>> result(INF, std::vector<vertex>());
+    id_type s = names.id(src), d = names.id(dst);
+    if (s == npos || d == npos)
+        return result;
+
+    std::pair<edge, std::vector<id_type>> found = network.shortest_path(s, d, bidirectional);
+    result.first = found.first;
+    for (id_type u : found.second)
+        result.second.push_back(names.vertex_at(u));
+    return result;
+}
+
+/**
+ * Returns the number of vertices in the graph.
+ *
+ * @return The size of the graph, i.e., the number of vertices.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename InternedGraph<vertex, edge, direction>::size_type InternedGraph<vertex, edge, direction>::size() const {
+    return network.size();
+}
+
+/**
+ * Checks if the graph is empty.
+ *
+ * @return true if the graph is empty, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool InternedGraph<vertex, edge, direction>::empty() const {
+    return network.empty();
+}
+
+/**
+ * Checks if a path connects two vertices, ignoring the direction of edges. Answered from a union-find
+ * kept up to date by every added edge, in near constant time unless an edge was deleted since the last query.
+ *
+ * @param node1 The first vertex.
+ * @param node2 The second vertex.
+ *
+ * @return true if both vertices are in the graph and in the same component, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool InternedGraph<vertex, edge, direction>::connected(const vertex &node1, const vertex &node2) {
+    id_type u = names.id(node1), v = names.id(node2);
+    if (u == npos || v == npos)
+        return false;
+    if (stale)
+        rebuild();
+    components.resize(names.size());
+    return components.connected(u, v);
+}
+
+/**
+ * Returns the number of connected components, ignoring the direction of edges.
+ *
+ * @return The number of components, an isolated vertex counting as one.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename InternedGraph<vertex, edge, direction>::size_type InternedGraph<vertex, edge, direction>::component_count() {
+    if (stale)
+        rebuild();
+    components.resize(names.size());
+    return components.count();
+}
+
+/**
+ * Looks up the id a vertex was interned under.
+ *
+ * @param node The vertex to look up.
+ *
+ * @return The id of the vertex, or npos if it was never added.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename InternedGraph<vertex, edge, direction>::id_type InternedGraph<vertex, edge, direction>::id(const vertex &node) const {
+    return names.id(node);
+}
+
+/**
+ * Returns the vertex interned under an id.
+ *
+ * @param u An id returned by id().
+ *
+ * @return The vertex with id u.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &InternedGraph<vertex, edge, direction>::vertex_at(id_type u) const {
+    return names.vertex_at(u);
+}
+
+/**
+ * Returns the underlying graph over ids, on which every Graph algorithm and iterator runs with integer vertices.
+ * Changes made through it are not tracked, so the components are rebuilt on the next query.
+ *
+ * @return The graph of interned ids.
+ */
+template <typename vertex, typename edge, Direction direction>
+Graph<typename InternedGraph<vertex, edge, direction>::id_type, edge, direction> &InternedGraph<vertex, edge, direction>::graph() {
+    stale = true;
+    return network;
+}
+
+/**
+ * Returns the underlying graph over ids, on which every Graph algorithm and iterator runs with integer vertices.
+ *
+ * @return The graph of interned ids.
+ */
+template <typename vertex, typename edge, Direction direction>
+const Graph<typename InternedGraph<vertex, edge, direction>::id_type, edge, direction> &InternedGraph<vertex, edge, direction>::graph() const {
+    return network;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+template <typename vertex = int // VertexInterner::vertex_type
+          >
+class VertexInterner {
+public:
+    typedef vertex vertex_type;
+    typedef uint32_t id_type;
+    typedef size_t size_type;
+
+    // Returned by id() for vertices that were never interned
+    static constexpr id_type npos = UINT32_MAX;
+
+private:
+    // Dense id -> vertex
+    std::vector<vertex> vertices;
+
+    // Vertex -> dense id
+    std::unordered_map<vertex, id_type> ids;
+
+public:
+    id_type intern(const vertex &);
+    id_type id(const vertex &) const;
+    const vertex &vertex_at(id_type) const;
+    size_type size() const;
+    bool empty() const;
+    void reserve(size_type);
+};
+
+/**
+ * Returns the id of a vertex, assigning the next free id the first time the vertex is seen.
+ *
+ * @param node The vertex to intern.
+ *
+ * @return The dense id of the vertex.
+ */
+template <typename vertex>
+typename VertexInterner<vertex>::id_type VertexInterner<vertex>::intern(const vertex &node) {
+    std::pair<typename std::unordered_map<vertex, id_type>::iterator, bool> it = ids.emplace(node, static_cast<id_type>(vertices.size()));
+    if (it.second)
+        vertices.push_back(node);
+    return it.first->second;
+}
+
+/**
+ * Looks up the id of a vertex without interning it.
+ *
+ * @param node The vertex to look up.
+ *
+ * @return The dense id of the vertex, or npos if it was never interned.
+ */
+template <typename vertex>
+typename VertexInterner<vertex>::id_type VertexInterner<vertex>::id(const vertex &node) const {
+    typename std::unordered_map<vertex, id_type>::const_iterator it = ids.find(node);
+    return it == ids.end() ? npos : it->second;
+}
+
+/**
+ * Returns the vertex with the given id.
+ *
+ * @param u A dense id smaller than size().
+ *
+ * @return The vertex interned under u.
+ */
+template <typename vertex>
+const vertex &VertexInterner<vertex>::vertex_at(id_type u) const {
+    return vertices[u];
+}
+
+/**
+ * Returns the number of interned vertices.
+ *
+ * @return The number of ids handed out.
+ */
+template <typename vertex>
+typename VertexInterner<vertex>::size_type VertexInterner<vertex>::size() const {
+    return vertices.size();
+}
+
+/**
+ * Checks if no vertex was interned yet.
+ *
+ * @return true if the interner is empty, false otherwise.
+ */
+template <typename vertex>
+bool VertexInterner<vertex>::empty() const {
+    return vertices.empty();
+}
+
+/**
+ * Reserves room for the given number of vertices.
+ *
+ * @param n The expected number of vertices.
+ *
+ * @return void
+ */
+template <typename vertex>
+void VertexInterner<vertex>::reserve(size_type n) {
+    vertices.reserve(n);
+    ids.reserve(n);
+}
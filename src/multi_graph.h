@@ -0,0 +1,476 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+
+// Value of type value for every edge id of a MultiGraph, stored in a flat array indexed by id
+template <typename value // EdgeAttribute::value_type
+          >
+class EdgeAttribute {
+public:
+    typedef value value_type;
+    typedef uint32_t edge_id;
+    typedef size_t size_type;
+
+private:
+    std::vector<value> values;
+    value fallback;
+
+public:
+    explicit EdgeAttribute(const value & = value());
+
+    value &operator[](edge_id);
+    const value &operator[](edge_id) const;
+    size_type size() const;
+};
+
+/**
+ * Constructs an attribute holding the default value for every edge.
+ *
+ * @param default_value The value of edges that were never assigned one.
+ */
+template <typename value>
+EdgeAttribute<value>::EdgeAttribute(const value &default_value) : fallback(default_value) {}
+
+/**
+ * Returns the value of an edge, growing the array up to the edge id if needed.
+ *
+ * @param e An edge id handed out by MultiGraph::add_edge.
+ *
+ * @return A reference to the value of e.
+ */
+template <typename value>
+value &EdgeAttribute<value>::operator[](edge_id e) {
+    if (e >= values.size())
+        values.resize(static_cast<size_type>(e) + 1, fallback);
+    return values[e];
+}
+
+/**
+ * Returns the value of an edge.
+ *
+ * @param e An edge id handed out by MultiGraph::add_edge.
+ *
+ * @return The value of e, or the default value if e was never assigned one.
+ */
+template <typename value>
+const value &EdgeAttribute<value>::operator[](edge_id e) const {
+    return e < values.size() ? values[e] : fallback;
+}
+
+/**
+ * Returns the number of slots in the array, one past the largest edge id assigned so far.
+ *
+ * @return The size of the array.
+ */
+template <typename value>
+typename EdgeAttribute<value>::size_type EdgeAttribute<value>::size() const {
+    return values.size();
+}
+
+template <typename vertex = int,                         // MultiGraph::vertex_type
+          typename edge = double,                        // MultiGraph::edge_type
+          Direction direction = Direction::undirected    // MultiGraph::orientation
+          >
+class MultiGraph {
+public:
+    typedef vertex vertex_type;
+    typedef edge edge_type;
+    typedef uint32_t edge_id;
+    typedef size_t size_type;
+
+    // Returned for edges that do not exist
+    static constexpr edge_id npos = UINT32_MAX;
+
+private:
+    // Endpoints and weight of every edge id ever handed out, ids are never reused
+    std::vector<std::pair<vertex, vertex>> ends;
+    std::vector<edge> weights;
+    std::vector<bool> live;
+    size_type live_count;
+
+    // Parallel edges between a pair of vertices, ordered (smaller, larger) for undirected graphs
+    struct bundle {
+        std::vector<edge_id> ids;
+        edge_id cheapest;
+    };
+    std::map<std::pair<vertex, vertex>, bundle> bundles;
+
+    // One edge per bundle carrying the smallest weight, so the search algorithms of Graph run unchanged
+    Graph<vertex, edge, direction> network;
+
+    std::pair<vertex, vertex> key(const vertex &, const vertex &) const;
+    void update_cheapest(bundle &, const vertex &, const vertex &);
+
+public:
+    MultiGraph();
+
+    edge_id add_edge(const vertex &, const vertex &, const edge = edge_type());
+    void delete_edge(edge_id);
+    void delete_edges(const vertex &, const vertex &);
+    void modify_edge(edge_id, const edge);
+    bool has_edge(const vertex &, const vertex &) const;
+    bool contains(edge_id) const;
+    const std::vector<edge_id> &edges(const vertex &, const vertex &) const;
+    edge_id cheapest(const vertex &, const vertex &) const;
+
+    const vertex &source(edge_id) const;
+    const vertex &target(edge_id) const;
+    const edge &weight(edge_id) const;
+    size_type edge_count() const;
+    size_type edge_bound() const;
+
+    std::map<vertex, std::pair<vertex, edge>> dijkstra(const vertex &);
+    std::pair<edge, std::vector<vertex>> shortest_path(const vertex &, const vertex &, bool = false) const;
+    template <typename heuristic>
+    std::pair<edge, std::vector<vertex>> astar(const vertex &, const vertex &, heuristic) const;
+    size_type size() const;
+    bool empty() const;
+    CsrGraph<vertex, edge> freeze() const;
+
+    const Graph<vertex, edge, direction> &graph() const;
+};
+
+/**
+ * Constructs an empty multigraph.
+ */
+template <typename vertex, typename edge, Direction direction>
+MultiGraph<vertex, edge, direction>::MultiGraph() : live_count(0) {}
+
+/**
+ * Returns the bundle key of the edges between two vertices, which does not depend on their order
+ * in undirected graphs.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ *
+ * @return The pair of vertices the bundle is stored under.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::pair<vertex, vertex> MultiGraph<vertex, edge, direction>::key(const vertex &node1, const vertex &node2) const {
+    if (direction == Direction::undirected && node2 < node1)
+        return std::make_pair(node2, node1);
+    return std::make_pair(node1, node2);
+}
+
+/**
+ * Finds the lightest edge of a bundle again after it lost its lightest edge or changed weights,
+ * and copies its weight to the collapsed graph.
+ *
+ * @param b The bundle, holding at least one edge.
+ * @param node1 The first node of the bundle.
+ * @param node2 The second node of the bundle.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void MultiGraph<vertex, edge, direction>::update_cheapest(bundle &b, const vertex &node1, const vertex &node2) {
+    b.cheapest = b.ids.front();
+    for (edge_id e : b.ids) {
+        if (weights[e] < weights[b.cheapest])
+            b.cheapest = e;
+    }
+    network.modify_edge(node1, node2, weights[b.cheapest]);
+}
+
+/**
+ * Adds an edge between two vertices, keeping any edges already between them.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ * @param weight The weight of the edge.
+ *
+ * @return The id of the new edge, which stays valid until the edge is deleted.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename MultiGraph<vertex, edge, direction>::edge_id MultiGraph<vertex, edge, direction>::add_edge(const vertex &node1, const vertex &node2,
+                                                                                                    const edge weight) {
+    edge_id e = static_cast<edge_id>(ends.size());
+    ends.emplace_back(node1, node2);
+    weights.push_back(weight);
+    live.push_back(true);
+    ++live_count;
+
+    bundle &b = bundles[key(node1, node2)];
+    b.ids.push_back(e);
+    if (b.ids.size() == 1) {
+        b.cheapest = e;
+        network.add_edge(node1, node2, weight);
+    } else if (weight < weights[b.cheapest]) {
+        b.cheapest = e;
+        network.modify_edge(node1, node2, weight);
+    }
+    return e;
+}
+
+/**
+ * Deletes one edge. The vertices stay in the graph, like Graph::delete_edge.
+ *
+ * @param e The id of the edge, ignored if it was already deleted.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void MultiGraph<vertex, edge, direction>::delete_edge(edge_id e) {
+    if (!contains(e))
+        return;
+    live[e] = false;
+    --live_count;
+
+    const vertex &node1 = ends[e].first, &node2 = ends[e].second;
+    typename std::map<std::pair<vertex, vertex>, bundle>::iterator it = bundles.find(key(node1, node2));
+    bundle &b = it->second;
+    b.ids.erase(std::find(b.ids.begin(), b.ids.end(), e));
+    if (b.ids.empty()) {
+        network.delete_edge(node1, node2);
+        bundles.erase(it);
+    } else if (b.cheapest == e) {
+        update_cheapest(b, node1, node2);
+    }
+}
+
+/**
+ * Deletes every edge between two vertices.
+ *
+ * @param node1 The first node of the edges to be deleted.
+ * @param node2 The second node of the edges to be deleted.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void MultiGraph<vertex, edge, direction>::delete_edges(const vertex &node1, const vertex &node2) {
+    typename std::map<std::pair<vertex, vertex>, bundle>::iterator it = bundles.find(key(node1, node2));
+    if (it == bundles.end())
+        return;
+    for (edge_id e : it->second.ids)
+        live[e] = false;
+    live_count -= it->second.ids.size();
+    network.delete_edge(node1, node2);
+    bundles.erase(it);
+}
+
+/**
+ * Changes the weight of one edge, leaving its parallel edges alone.
+ *
+ * @param e The id of the edge, ignored if it was deleted.
+ * @param new_weight The new weight for the edge.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge, Direction direction>
+void MultiGraph<vertex, edge, direction>::modify_edge(edge_id e, const edge new_weight) {
+    if (!contains(e))
+        return;
+    edge old_weight = weights[e];
+    weights[e] = new_weight;
+
+    const vertex &node1 = ends[e].first, &node2 = ends[e].second;
+    bundle &b = bundles.find(key(node1, node2))->second;
+    if (new_weight < weights[b.cheapest] || (b.cheapest == e && new_weight < old_weight)) {
+        b.cheapest = e;
+        network.modify_edge(node1, node2, new_weight);
+    } else if (b.cheapest == e) {
+        update_cheapest(b, node1, node2);
+    }
+}
+
+/**
+ * Checks if at least one edge connects two vertices.
+ *
+ * @param node1 The first node of the edge.
+ * @param node2 The second node of the edge.
+ *
+ * @return true if an edge exists, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool MultiGraph<vertex, edge, direction>::has_edge(const vertex &node1, const vertex &node2) const {
+    return bundles.find(key(node1, node2)) != bundles.end();
+}
+
+/**
+ * Checks if an edge id refers to an edge that has not been deleted.
+ *
+ * @param e The edge id to check.
+ *
+ * @return true if the edge exists, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool MultiGraph<vertex, edge, direction>::contains(edge_id e) const {
+    return e < live.size() && live[e];
+}
+
+/**
+ * Returns the ids of the parallel edges between two vertices.
+ *
+ * @param node1 The first node of the edges.
+ * @param node2 The second node of the edges.
+ *
+ * @return The edge ids in the order the edges were added, empty if the vertices are not connected.
+ */
+template <typename vertex, typename edge, Direction direction>
+const std::vector<typename MultiGraph<vertex, edge, direction>::edge_id> &MultiGraph<vertex, edge, direction>::edges(const vertex &node1,
+                                                                                                                    const vertex &node2) const {
+    static const std::vector<edge_id> none;
+    typename std::map<std::pair<vertex, vertex>, bundle>::const_iterator it = bundles.find(key(node1, node2));
+    return it == bundles.end() ? none : it->second.ids;
+}
+
+/**
+ * Returns the lightest of the parallel edges between two vertices, the one shortest paths travel along.
+ *
+ * @param node1 The first node of the edges.
+ * @param node2 The second node of the edges.
+ *
+ * @return The id of an edge with the smallest weight, or npos if the vertices are not connected.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename MultiGraph<vertex, edge, direction>::edge_id MultiGraph<vertex, edge, direction>::cheapest(const vertex &node1, const vertex &node2) const {
+    typename std::map<std::pair<vertex, vertex>, bundle>::const_iterator it = bundles.find(key(node1, node2));
+    return it == bundles.end() ? npos : it->second.cheapest;
+}
+
+/**
+ * Returns the vertex an edge was added from.
+ *
+ * @param e An edge id smaller than edge_bound().
+ *
+ * @return The first node passed to add_edge.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &MultiGraph<vertex, edge, direction>::source(edge_id e) const {
+    return ends[e].first;
+}
+
+/**
+ * Returns the vertex an edge was added to.
+ *
+ * @param e An edge id smaller than edge_bound().
+ *
+ * @return The second node passed to add_edge.
+ */
+template <typename vertex, typename edge, Direction direction>
+const vertex &MultiGraph<vertex, edge, direction>::target(edge_id e) const {
+    return ends[e].second;
+}
+
+/**
+ * Returns the weight of an edge.
+ *
+ * @param e An edge id smaller than edge_bound().
+ *
+ * @return The weight of the edge.
+ */
+template <typename vertex, typename edge, Direction direction>
+const edge &MultiGraph<vertex, edge, direction>::weight(edge_id e) const {
+    return weights[e];
+}
+
+/**
+ * Returns the number of edges, counting parallel edges separately.
+ *
+ * @return The number of edges that have not been deleted.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename MultiGraph<vertex, edge, direction>::size_type MultiGraph<vertex, edge, direction>::edge_count() const {
+    return live_count;
+}
+
+/**
+ * Returns one past the largest edge id handed out, the size a flat array indexed by edge id needs.
+ *
+ * @return The number of edge ids handed out, including those of deleted edges.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename MultiGraph<vertex, edge, direction>::size_type MultiGraph<vertex, edge, direction>::edge_bound() const {
+    return ends.size();
+}
+
+/**
+ * Finds the shortest path from the given source vertex to all other vertices using Dijkstra's algorithm,
+ * along the lightest of every group of parallel edges.
+ *
+ * @param src The source vertex from which to find the shortest path.
+ *
+ * @return A map of vertices to pairs containing the previous vertex and the weight of the shortest path.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::map<vertex, std::pair<vertex, edge>> MultiGraph<vertex, edge, direction>::dijkstra(const vertex &src) {
+    return network.dijkstra(src);
+}
+
+/**
+ * Finds the shortest path between two vertices along the lightest of every group of parallel edges.
+ * cheapest() tells which edge was taken between consecutive vertices of the path.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param bidirectional Search from both ends at once and stop when the two searches meet.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+std::pair<edge, std::vector<vertex>> MultiGraph<vertex, edge, direction>::shortest_path(const vertex &src, const vertex &dst, bool bidirectional) const {
+    return network.shortest_path(src, dst, bidirectional);
+}
+
+/**
+ * Finds the shortest path between two vertices with A* search along the lightest of every group of parallel edges.
+ *
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param h Callable h(node, dst) returning a lower bound of the distance from node to dst.
+ *
+ * @return A pair of the path length and the vertices on the path from src to dst,
+ *         or (INF, empty vector) if dst cannot be reached.
+ */
+template <typename vertex, typename edge, Direction direction>
+template <typename heuristic>
+std::pair<edge, std::vector<vertex>> MultiGraph<vertex, edge, direction>::astar(const vertex &src, const vertex &dst, heuristic h) const {
+    return network.astar(src, dst, h);
+}
+
+/**
+ * Returns the number of vertices in the graph.
+ *
+ * @return The number of vertices.
+ */
+template <typename vertex, typename edge, Direction direction>
+typename MultiGraph<vertex, edge, direction>::size_type MultiGraph<vertex, edge, direction>::size() const {
+    return network.size();
+}
+
+/**
+ * Checks if the graph is empty.
+ *
+ * @return true if there are no vertices, false otherwise.
+ */
+template <typename vertex, typename edge, Direction direction>
+bool MultiGraph<vertex, edge, direction>::empty() const {
+    return network.empty();
+}
+
+/**
+ * Builds a snapshot in which every group of parallel edges is collapsed to its lightest edge.
+ *
+ * @return A CsrGraph holding the current vertices and one edge per connected pair.
+ */
+template <typename vertex, typename edge, Direction direction>
+CsrGraph<vertex, edge> MultiGraph<vertex, edge, direction>::freeze() const {
+    return network.freeze();
+}
+
+/**
+ * Returns the collapsed graph holding the lightest edge between every connected pair of vertices.
+ *
+ * @return A read-only reference to the collapsed graph.
+ */
+template <typename vertex, typename edge, Direction direction>
+const Graph<vertex, edge, direction> &MultiGraph<vertex, edge, direction>::graph() const {
+    return network;
+}
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "indexed_heap.h"
+
+// Shortest path distances and predecessors indexed by the dense ids of a CsrGraph
+template <typename edge>
+struct ShortestPathTree {
+    // INF for vertices that cannot be reached
+    std::vector<edge> distance;
+
+    // Previous vertex on the shortest path, the source for itself, CsrGraph::npos if unreachable
+    std::vector<uint32_t> parent;
+};
+
+template <typename vertex = int, // ShortestPathEngine::vertex_type
+          typename edge = double // ShortestPathEngine::edge_type
+          >
+class ShortestPathEngine {
+public:
+    typedef vertex vertex_type;
+    typedef edge edge_type;
+    typedef typename CsrGraph<vertex, edge>::id_type id_type;
+    typedef typename CsrGraph<vertex, edge>::size_type size_type;
+
+private:
+    // Scratch buffers of one search direction, reused by every run
+    struct search_state {
+        IndexedHeap<edge> heap;
+        ShortestPathTree<edge> tree;
+
+        // Ids whose entries in tree differ from the initial state
+        std::vector<id_type> touched;
+    };
+
+    const CsrGraph<vertex, edge> &graph;
+    search_state forward;
+    search_state backward;
+
+    // Edge joining the two searches of the last bidirectional run, npos otherwise
+    id_type meet_forward;
+    id_type meet_backward;
+
+    // The last run searched from both ends, so backward holds its reverse search; forward-only runs leave
+    // backward as it was and reset it lazily on the next bidirectional run
+    bool bidirectional_run;
+
+    // Vertices settled by the last bounded run with their distances, in order of distance
+    std::vector<std::pair<id_type, edge>> nearby;
+
+    void reset(search_state &);
+    bool relax(search_state &, id_type, id_type, const edge &, const edge &);
+    template <typename heuristic>
+    edge search(id_type, id_type, heuristic &);
+
+public:
+    explicit ShortestPathEngine(const CsrGraph<vertex, edge> &);
+
+    void run(id_type);
+    edge run(id_type, id_type);
+    edge run_bidirectional(id_type, id_type);
+    template <typename heuristic>
+    edge run_astar(id_type, id_type, heuristic);
+    const std::vector<std::pair<id_type, edge>> &run_nearest(id_type, size_type, const edge & = std::numeric_limits<edge>::max());
+    const std::vector<std::pair<id_type, edge>> &run_within(id_type, const edge &);
+    std::vector<id_type> path_to(id_type) const;
+    size_type reached() const;
+    const ShortestPathTree<edge> &result() const;
+    ShortestPathTree<edge> release();
+    std::map<vertex, std::pair<vertex, edge>> to_map() const;
+};
+
+/**
+ * Constructs an engine answering queries on the given snapshot.
+ * The snapshot must outlive the engine.
+ *
+ * @param graph_ The snapshot to search.
+ */
+template <typename vertex, typename edge>
+ShortestPathEngine<vertex, edge>::ShortestPathEngine(const CsrGraph<vertex, edge> &graph_)
+    : graph(graph_), meet_forward(CsrGraph<vertex, edge>::npos), meet_backward(CsrGraph<vertex, edge>::npos), bidirectional_run(false) {
+    reset(forward);
+}
+
+/**
+ * Restores the entries touched by the previous run, so a new run costs only what it explores.
+ *
+ * @param state The search direction to reset.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void ShortestPathEngine<vertex, edge>::reset(search_state &state) {
+    if (state.tree.distance.size() != graph.size()) {
+        state.tree.distance.assign(graph.size(), INF);
+        state.tree.parent.assign(graph.size(), CsrGraph<vertex, edge>::npos);
+        state.heap.resize(graph.size());
+        state.touched.clear();
+    }
+    for (id_type u : state.touched) {
+        state.tree.distance[u] = INF;
+        state.tree.parent[u] = CsrGraph<vertex, edge>::npos;
+    }
+    state.touched.clear();
+    state.heap.clear();
+    meet_forward = meet_backward = CsrGraph<vertex, edge>::npos;
+    bidirectional_run = false;
+}
+
+/**
+ * Lowers the tentative distance of v if the path through u is shorter.
+ *
+ * @param state The search direction the edge belongs to.
+ * @param u The vertex the edge leaves from.
+ * @param v The vertex the edge leads to.
+ * @param dv The length of the path to v through u.
+ * @param key The heap key of v, dv plus any heuristic estimate.
+ *
+ * @return true if the distance of v was lowered, false otherwise.
+ */
+template <typename vertex, typename edge>
+bool ShortestPathEngine<vertex, edge>::relax(search_state &state, id_type u, id_type v, const edge &dv, const edge &key) {
+    GRAPH_COUNT(relaxations, 1);
+    // Unreached vertices hold INF, which paths of wide edge types can exceed, so they always take the first path
+    bool reached = state.tree.parent[v] != CsrGraph<vertex, edge>::npos;
+    if (reached && !(dv < state.tree.distance[v]))
+        return false;
+    if (!reached)
+        state.touched.push_back(v);
+    state.tree.distance[v] = dv;
+    state.tree.parent[v] = u;
+    state.heap.push_or_decrease(v, key);
+    return true;
+}
+
+/**
+ * Finds the shortest path from the source to every reachable vertex using Dijkstra's algorithm
+ * with an indexed 4-ary heap that decreases keys in place.
+ *
+ * @param src The dense id of the source vertex.
+ *
+ * @return void
+ */
+template <typename vertex, typename edge>
+void ShortestPathEngine<vertex, edge>::run(id_type src) {
+    run(src, CsrGraph<vertex, edge>::npos);
+}
+
+/**
+ * Finds the shortest path from the source to the destination, stopping as soon as the destination is settled.
+ * Only the vertices settled before the destination have final distances in result().
+ *
+ * @param src The dense id of the source vertex.
+ * @param dst The dense id of the destination vertex, or npos to settle the whole graph.
+ *
+ * @return The length of the shortest path, or INF if dst cannot be reached.
+ */
+template <typename vertex, typename edge>
+edge ShortestPathEngine<vertex, edge>::run(id_type src, id_type dst) {
+    zeroHeuristic<edge> h;
+    return search(src, dst, h);
+}
+
+/**
+ * Finds the shortest path from the source to the destination with A* search.
+ * The heuristic must never overestimate the remaining distance.
+ *
+ * @param src The dense id of the source vertex.
+ * @param dst The dense id of the destination vertex.
+ * @param h Callable h(u, dst) on dense ids returning a lower bound of the distance from u to dst.
+ *
+ * @return The length of the shortest path, or INF if dst cannot be reached.
+ */
+template <typename vertex, typename edge>
+template <typename heuristic>
+edge ShortestPathEngine<vertex, edge>::run_astar(id_type src, id_type dst, heuristic h) {
+    if (dst >= graph.size()) {
+        reset(forward);
+        return INF;
+    }
+    return search(src, dst, h);
+}
+
+/**
+ * Settles vertices in order of distance plus heuristic estimate until the destination is settled.
+ * Vertices reached again through a shorter path are pushed back into the heap, so admissible but
+ * inconsistent heuristics still give exact distances.
+ *
+ * @param src The dense id of the source vertex.
+ * @param dst The dense id of the destination vertex, or npos to settle the whole graph.
+ * @param h Callable h(u, dst) estimating the distance from u to dst.
+ *
+ * @return The length of the shortest path, or INF if dst cannot be reached.
+ */
+template <typename vertex, typename edge>
+template <typename heuristic>
+edge ShortestPathEngine<vertex, edge>::search(id_type src, id_type dst, heuristic &h) {
+    reset(forward);
+    if (src >= graph.size())
+        return INF;
+
+    forward.tree.distance[src] = edge();
+    forward.tree.parent[src] = src;
+    forward.touched.push_back(src);
+    forward.heap.push(src, h(src, dst));
+
+    while (!forward.heap.empty()) {
+        id_type u = forward.heap.top();
+        forward.heap.pop();
+        GRAPH_COUNT(vertices_visited, 1);
+        if (u == dst)
+            break;
+
+        edge du = forward.tree.distance[u];
+        for (size_type e = graph.edge_begin(u); e < graph.edge_end(u); ++e) {
+            id_type v = graph.target(e);
+            edge dv = du + graph.weight(e);
+            relax(forward, u, v, dv, dv + h(v, dst));
+        }
+    }
+    return dst < graph.size() ? forward.tree.distance[dst] : edge(INF);
+}
+
+/**
+ * Finds the k vertices closest to the source, the source included, stopping once the k-th is settled or
+ * the closest vertex left lies further away than max_distance. Edges leading beyond max_distance are not
+ * relaxed, so the heap only holds vertices that can still be reported, and the search costs only what it
+ * explores, which keeps repeated queries on one engine cheap on large graphs.
+ *
+ * @param src The dense id of the source vertex.
+ * @param k The largest number of vertices to report.
+ * @param max_distance The largest distance to report vertices at.
+ *
+ * @return (dense id, distance) pairs in order of distance; valid until the next run.
+ */
+template <typename vertex, typename edge>
+const std::vector<std::pair<typename ShortestPathEngine<vertex, edge>::id_type, edge>> &ShortestPathEngine<vertex, edge>::run_nearest(id_type src, size_type k,
+                                                                                                                                     const edge &max_distance) {
+    reset(forward);
+    nearby.clear();
+    if (src >= graph.size() || k == 0 || max_distance < edge())
+        return nearby;
+
+    forward.tree.distance[src] = edge();
+    forward.tree.parent[src] = src;
+    forward.touched.push_back(src);
+    forward.heap.push(src, edge());
+
+    while (!forward.heap.empty() && !(max_distance < forward.heap.top_key())) {
+        id_type u = forward.heap.top();
+        edge du = forward.heap.top_key();
+        forward.heap.pop();
+        GRAPH_COUNT(vertices_visited, 1);
+        nearby.emplace_back(u, du);
+        if (nearby.size() == k)
+            break;
+
+        for (size_type e = graph.edge_begin(u); e < graph.edge_end(u); ++e) {
+            edge dv = du + graph.weight(e);
+            if (!(max_distance < dv))
+                relax(forward, u, graph.target(e), dv, dv);
+        }
+    }
+    return nearby;
+}
+
+/**
+ * Finds every vertex within a distance of the source, the source included, stopping once the next
+ * closest vertex lies further away.
+ *
+ * @param src The dense id of the source vertex.
+ * @param max_distance The largest distance to report vertices at.
+ *
+ * @return (dense id, distance) pairs in order of distance; valid until the next run.
+ */
+template <typename vertex, typename edge>
+const std::vector<std::pair<typename ShortestPathEngine<vertex, edge>::id_type, edge>> &ShortestPathEngine<vertex, edge>::run_within(id_type src, const edge &max_distance) {
+    return run_nearest(src, SIZE_MAX, max_distance);
+}
+
+/**
+ * Finds the shortest path from the source to the destination by searching from both ends at once
+ * and stopping when the two frontiers can no longer improve the best meeting point.
+ *
+ * @param src The dense id of the source vertex.
+ * @param dst The dense id of the destination vertex.
+ *
+ * @return The length of the shortest path, or INF if dst cannot be reached.
+ */
+template <typename vertex, typename edge>
+edge ShortestPathEngine<vertex, edge>::run_bidirectional(id_type src, id_type dst) {
+    reset(forward);
+    reset(backward);
+    bidirectional_run = true;
+    if (src >= graph.size() || dst >= graph.size())
+        return INF;
+    if (src == dst)
+        return run(src, dst);
+
+    forward.tree.distance[src] = edge();
+    forward.tree.parent[src] = src;
+    forward.touched.push_back(src);
+    forward.heap.push(src, edge());
+
+    backward.tree.distance[dst] = edge();
+    backward.tree.parent[dst] = dst;
+    backward.touched.push_back(dst);
+    backward.heap.push(dst, edge());
+
+    edge best = INF;
+    while (!forward.heap.empty() && !backward.heap.empty()) {
+        if (!(forward.heap.top_key() + backward.heap.top_key() < best))
+            break;
+
+        // Expand the side with the smaller frontier key; the backward search follows the edges entering
+        // every vertex, which for an undirected snapshot are its out-edges
+        bool is_forward = !(backward.heap.top_key() < forward.heap.top_key());
+        search_state &side = is_forward ? forward : backward;
+        search_state &other = is_forward ? backward : forward;
+
+        id_type u = side.heap.top();
+        edge du = side.heap.top_key();
+        side.heap.pop();
+        GRAPH_COUNT(vertices_visited, 1);
+
+        size_type first = is_forward ? graph.edge_begin(u) : graph.in_edge_begin(u);
+        size_type last = is_forward ? graph.edge_end(u) : graph.in_edge_end(u);
+        for (size_type e = first; e < last; ++e) {
+            id_type v = is_forward ? graph.target(e) : graph.in_target(e);
+            edge dv = du + (is_forward ? graph.weight(e) : graph.in_weight(e));
+            relax(side, u, v, dv, dv);
+            if (other.tree.parent[v] != CsrGraph<vertex, edge>::npos && dv + other.tree.distance[v] < best) {
+                best = dv + other.tree.distance[v];
+                meet_forward = is_forward ? u : v;
+                meet_backward = is_forward ? v : u;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Reconstructs the shortest path found by the last run.
+ * After run_bidirectional() only the path to its destination is available.
+ *
+ * @param dst The dense id of the destination vertex.
+ *
+ * @return The dense ids on the path from the source to dst, or an empty vector if dst was not reached.
+ */
+template <typename vertex, typename edge>
+std::vector<typename ShortestPathEngine<vertex, edge>::id_type> ShortestPathEngine<vertex, edge>::path_to(id_type dst) const {
+    std::vector<id_type> path;
+    id_type u = dst;
+    if (meet_forward != CsrGraph<vertex, edge>::npos)
+        u = meet_forward;
+    else if (dst >= graph.size() || forward.tree.parent[dst] == CsrGraph<vertex, edge>::npos)
+        return path;
+
+    while (forward.tree.parent[u] != u) {
+        path.push_back(u);
+        u = forward.tree.parent[u];
+    }
+    path.push_back(u);
+    std::reverse(path.begin(), path.end());
+
+    if (meet_forward != CsrGraph<vertex, edge>::npos) {
+        for (u = meet_backward; backward.tree.parent[u] != u; u = backward.tree.parent[u])
+            path.push_back(u);
+        path.push_back(u);
+    }
+    return path;
+}
+
+/**
+ * Returns how many vertices the last run assigned a distance to, a measure of the work it did.
+ *
+ * @return The number of vertices reached by the last run, summed over both directions.
+ */
+template <typename vertex, typename edge>
+typename ShortestPathEngine<vertex, edge>::size_type ShortestPathEngine<vertex, edge>::reached() const {
+    return forward.touched.size() + (bidirectional_run ? backward.touched.size() : 0);
+}
+
+/**
+ * Returns the distances and predecessors computed by the last run.
+ *
+ * @return The flat shortest path tree, indexed by dense id.
+ */
+template <typename vertex, typename edge>
+const ShortestPathTree<edge> &ShortestPathEngine<vertex, edge>::result() const {
+    return forward.tree;
+}
+
+/**
+ * Moves the result of the last run out of the engine. The next run reallocates its buffers.
+ *
+ * @return The flat shortest path tree, indexed by dense id.
+ */
+template <typename vertex, typename edge>
+ShortestPathTree<edge> ShortestPathEngine<vertex, edge>::release() {
+    forward.touched.clear();
+    return std::move(forward.tree);
+}
+
+/**
+ * Converts the result of the last run to the format returned by Graph::dijkstra.
+ *
+ * @return A map of vertices to pairs containing the previous vertex and the weight of the shortest path.
+ */
+template <typename vertex, typename edge>
+std::map<vertex, std::pair<vertex, edge>> ShortestPathEngine<vertex, edge>::to_map() const {
+    std::map<vertex, std::pair<vertex, edge>> path;
+    for (id_type u = 0; u < graph.size(); ++u) {
+        std::pair<vertex, edge> &p = path[graph.vertex_at(u)];
+        if (forward.tree.parent[u] != CsrGraph<vertex, edge>::npos)
+            p.first = graph.vertex_at(forward.tree.parent[u]);
+        p.second = forward.tree.distance[u];
+    }
+    return path;
+}
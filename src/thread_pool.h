@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // Job run by every thread of the current round, with the index of the thread
+    std::function<void(unsigned)> job;
+    size_t round;
+    unsigned pending;
+    bool stopping;
+    std::exception_ptr error;
+
+    void work(unsigned);
+    void execute(unsigned);
+
+public:
+    explicit ThreadPool(unsigned = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const;
+    void run(const std::function<void(unsigned)> &);
+    template <typename function>
+    void parallel_for(size_t, size_t, function, size_t = 1);
+};
+
+/**
+ * Starts the worker threads. The calling thread takes part in every job as thread 0.
+ *
+ * @param threads The total number of threads, 0 for one per hardware thread.
+ */
+inline ThreadPool::ThreadPool(unsigned threads) : round(0), pending(0), stopping(false) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; ++i)
+        workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+/**
+ * Stops and joins the worker threads.
+ */
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : workers)
+        t.join();
+}
+
+/**
+ * Returns the number of threads running each job, including the calling thread.
+ *
+ * @return The number of threads.
+ */
+inline unsigned ThreadPool::size() const {
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+/**
+ * Runs the job of the current round on one thread and records the first exception it throws.
+ *
+ * @param index The index of the thread.
+ *
+ * @return void
+ */
+inline void ThreadPool::execute(unsigned index) {
+    try {
+        job(index);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+            error = std::current_exception();
+    }
+}
+
+/**
+ * Main loop of a worker thread, waiting for rounds until the pool is destroyed.
+ *
+ * @param index The index of the thread.
+ *
+ * @return void
+ */
+inline void ThreadPool::work(unsigned index) {
+    size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || round != seen; });
+            if (stopping)
+                return;
+            seen = round;
+        }
+        execute(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0)
+                done.notify_one();
+        }
+    }
+}
+
+/**
+ * Runs a job once on every thread of the pool and waits for all of them to finish.
+ * An exception thrown by the job is rethrown on the calling thread.
+ *
+ * @param fn Callable fn(thread_index) with thread_index in 0 .. size() - 1.
+ *
+ * @return void
+ */
+inline void ThreadPool::run(const std::function<void(unsigned)> &fn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = fn;
+        error = nullptr;
+        pending = static_cast<unsigned>(workers.size());
+        ++round;
+    }
+    wake.notify_all();
+    execute(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending == 0; });
+    job = nullptr;
+    if (error)
+        std::rethrow_exception(error);
+}
+
+/**
+ * Calls fn(i, thread_index) for every i in [begin, end), handing out chunks of grain indices
+ * to whichever thread is free. thread_index selects per-thread scratch buffers.
+ *
+ * @param begin The first index.
+ * @param end One past the last index.
+ * @param fn Callable fn(i, thread_index).
+ * @param grain The number of consecutive indices a thread takes at once.
+ *
+ * @return void
+ */
+template <typename function>
+void ThreadPool::parallel_for(size_t begin, size_t end, function fn, size_t grain) {
+    if (begin >= end)
+        return;
+    grain = std::max<size_t>(grain, 1);
+    std::atomic<size_t> next(begin);
+    run([&](unsigned index) {
+        for (size_t i = next.fetch_add(grain); i < end; i = next.fetch_add(grain)) {
+            size_t last = std::min(end, i + grain);
+            for (size_t j = i; j < last; ++j)
+                fn(j, index);
+        }
+    });
+}
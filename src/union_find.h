@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Disjoint sets over dense ids 0 .. size() - 1, joined with union by size and searched with path halving,
+// so every operation takes near constant amortised time. Sets can only be joined, never split.
+class UnionFind {
+public:
+    typedef uint32_t id_type;
+    typedef size_t size_type;
+
+private:
+    std::vector<id_type> parent;
+    std::vector<id_type> weight;
+    size_type sets;
+
+public:
+    explicit UnionFind(size_type = 0);
+
+    void resize(size_type);
+    void clear();
+    id_type find(id_type);
+    bool unite(id_type, id_type);
+    bool connected(id_type, id_type);
+    size_type set_size(id_type);
+    size_type size() const;
+    size_type count() const;
+};
+
+/**
+ * Constructs n sets of one element each.
+ *
+ * @param n The number of ids.
+ */
+inline UnionFind::UnionFind(size_type n) : sets(0) {
+    resize(n);
+}
+
+/**
+ * Adds single element sets for new ids up to n. Never removes ids.
+ *
+ * @param n The number of ids.
+ *
+ * @return void
+ */
+inline void UnionFind::resize(size_type n) {
+    for (size_type u = parent.size(); u < n; ++u) {
+        parent.push_back(static_cast<id_type>(u));
+        weight.push_back(1);
+        ++sets;
+    }
+}
+
+/**
+ * Removes every id.
+ *
+ * @return void
+ */
+inline void UnionFind::clear() {
+    parent.clear();
+    weight.clear();
+    sets = 0;
+}
+
+/**
+ * Finds the representative of the set holding an id, pointing every other visited id at its grandparent.
+ *
+ * @param u An id smaller than size().
+ *
+ * @return The representative id.
+ */
+inline UnionFind::id_type UnionFind::find(id_type u) {
+    while (parent[u] != u) {
+        parent[u] = parent[parent[u]];
+        u = parent[u];
+    }
+    return u;
+}
+
+/**
+ * Joins the sets holding two ids, hanging the smaller set below the larger one.
+ *
+ * @param u An id smaller than size().
+ * @param v An id smaller than size().
+ *
+ * @return true if the ids were in different sets, false otherwise.
+ */
+inline bool UnionFind::unite(id_type u, id_type v) {
+    u = find(u);
+    v = find(v);
+    if (u == v)
+        return false;
+    if (weight[u] < weight[v])
+        std::swap(u, v);
+    parent[v] = u;
+    weight[u] += weight[v];
+    --sets;
+    return true;
+}
+
+/**
+ * Checks if two ids are in the same set.
+ *
+ * @param u An id smaller than size().
+ * @param v An id smaller than size().
+ *
+ * @return true if they have the same representative, false otherwise.
+ */
+inline bool UnionFind::connected(id_type u, id_type v) {
+    return find(u) == find(v);
+}
+
+/**
+ * Returns the number of ids in the set holding an id.
+ *
+ * @param u An id smaller than size().
+ *
+ * @return The size of the set.
+ */
+inline UnionFind::size_type UnionFind::set_size(id_type u) {
+    return weight[find(u)];
+}
+
+/**
+ * Returns the number of ids.
+ *
+ * @return The number of ids.
+ */
+inline UnionFind::size_type UnionFind::size() const {
+    return parent.size();
+}
+
+/**
+ * Returns the number of disjoint sets.
+ *
+ * @return The number of sets.
+ */
+inline UnionFind::size_type UnionFind::count() const {
+    return sets;
+}